@@ -704,21 +704,28 @@ void editorFind() {
 struct abuf {
   char *b;
   int len;
+  int cap;
 };
 
-#define ABUF_INIT {NULL, 0}
+#define ABUF_INIT {NULL, 0, 0}
 
 void abAppend(struct abuf *ab, const char *s, int len) {
-  char *new = realloc(ab->b, ab->len + len);
-
-  if (new == NULL) return;
-  memcpy(&new[ab->len], s, len);
-  ab->b = new;
+  if (ab->len + len > ab->cap) {
+    int cap = ab->cap ? ab->cap * 2 : 4096;
+    while (cap < ab->len + len) cap *= 2;
+    char *new = realloc(ab->b, cap);
+    if (new == NULL) return;
+    ab->b = new;
+    ab->cap = cap;
+  }
+  memcpy(&ab->b[ab->len], s, len);
   ab->len += len;
 }
 
 void abFree(struct abuf *ab) {
   free(ab->b);
+  ab->b = NULL;
+  ab->len = ab->cap = 0;
 }
 
 /*** output ***/
@@ -743,6 +750,28 @@ void editorScroll() {
   }
 }
 
+/* SGR sequence for each highlight class, formatted once */
+struct sgr {
+  char seq[8];
+  int len;
+  int color;  /* -1 for HL_NORMAL, whose sequence resets the colour */
+};
+
+const struct sgr *editorSyntaxSGR(int hl) {
+  static struct sgr cache[HL_MATCH + 1];
+  static int ready = 0;
+  if (!ready) {
+    int j;
+    for (j = 0; j <= HL_MATCH; j++) {
+      cache[j].color = (j == HL_NORMAL) ? -1 : editorSyntaxToColor(j);
+      cache[j].len = snprintf(cache[j].seq, sizeof(cache[j].seq), "\x1b[%dm",
+                              cache[j].color == -1 ? 39 : cache[j].color);
+    }
+    ready = 1;
+  }
+  return &cache[hl];
+}
+
 void editorDrawRows(struct abuf *ab) {
   int y;
   for (y = 0; y < E.screenrows; y++) {
@@ -769,35 +798,29 @@ void editorDrawRows(struct abuf *ab) {
       if (len > E.screencols) len = E.screencols;
       char *c = &E.row[filerow].render[E.coloff];
       unsigned char *hl = &E.row[filerow].hl[E.coloff];
-      int current_color = -1;
-      int j;
-      for (j = 0; j < len; j++) {
+      const struct sgr *current = editorSyntaxSGR(HL_NORMAL);
+      int j = 0;
+      /* emit whole runs of equally coloured text, one SGR and one copy per run */
+      while (j < len) {
         if (iscntrl(c[j])) {
-          char sym = (c[j] <= 26) ? '@' + c[j] : '?';
-          abAppend(ab, "\x1b[7m", 4);
-          abAppend(ab, &sym, 1);
-          abAppend(ab, "\x1b[m", 3);
-          if (current_color != -1) {
-            char buf[16];
-            int clen = snprintf(buf, sizeof(buf), "\x1b[%dm", current_color);
-            abAppend(ab, buf, clen);
-          }
-        } else if (hl[j] == HL_NORMAL) {
-          if (current_color != -1) {
-            abAppend(ab, "\x1b[39m", 5);
-            current_color = -1;
-          }
-          abAppend(ab, &c[j], 1);
-        } else {
-          int color = editorSyntaxToColor(hl[j]);
-          if (color != current_color) {
-            current_color = color;
-            char buf[16];
-            int clen = snprintf(buf, sizeof(buf), "\x1b[%dm", color);
-            abAppend(ab, buf, clen);
-          }
-          abAppend(ab, &c[j], 1);
+          char sym[8] = "\x1b[7m";
+          sym[4] = (c[j] <= 26) ? '@' + c[j] : '?';
+          memcpy(&sym[5], "\x1b[m", 3);
+          abAppend(ab, sym, 8);
+          if (current->color != -1) abAppend(ab, current->seq, current->len);
+          j++;
+          continue;
         }
+        const struct sgr *s = editorSyntaxSGR(hl[j]);
+        int k = j + 1;
+        while (k < len && !iscntrl(c[k]) &&
+               (hl[k] == hl[j] || editorSyntaxSGR(hl[k])->color == s->color)) k++;
+        if (s->color != current->color) {
+          abAppend(ab, s->seq, s->len);
+          current = s;
+        }
+        abAppend(ab, &c[j], k - j);
+        j = k;
       }
       abAppend(ab, "\x1b[39m", 5);
     }
@@ -841,7 +864,8 @@ void editorDrawMessageBar(struct abuf *ab) {
 void editorRefreshScreen() {
   editorScroll();
 
-  struct abuf ab = ABUF_INIT;
+  static struct abuf ab = ABUF_INIT; /* reused across frames, it only ever grows */
+  ab.len = 0;
 
   abAppend(&ab, "\x1b[?25l", 6);
   abAppend(&ab, "\x1b[H", 3);
@@ -858,7 +882,6 @@ void editorRefreshScreen() {
   abAppend(&ab, "\x1b[?25h", 6);
 
   write(STDOUT_FILENO, ab.b, ab.len);
-  abFree(&ab);
 }
 
 void editorSetStatusMessage(const char *fmt, ...) {
@@ -1049,6 +1072,7 @@ void initEditor() {
   E.screenrows -= 2;
 }
 
+#ifndef KILO_NO_MAIN /* bench/bench_kilo.c includes this file */
 int main(int argc, char *argv[]) {
   enableRawMode();
   initEditor();
@@ -1065,4 +1089,5 @@ int main(int argc, char *argv[]) {
   }
 
   return 0;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
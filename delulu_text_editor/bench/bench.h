@@ -0,0 +1,289 @@
+// Shared by the microbenchmarks (make bench): a synthetic corpus generator,a timing loop that
+// runs every kernel on every corpus in its own process,and one JSON object per result line.
+//
+//   -s MB     size of each corpus (default 16)
+//   -d dir    write the corpora there and keep them,otherwise a temporary directory is used
+//   -b name   run only this kernel
+//   -c name   run only this corpus
+//   -t ms     time budget per measurement (default 300)
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+struct bench_kernel
+{
+    const char *name;
+    void (*setup)(const char *path); // Untimed,e.g. load the corpus
+    long long (*run)(const char *path); // One timed iteration,returns the bytes it went through
+};
+
+static unsigned long long bench_rng = 88172645463325252ULL;
+
+static unsigned bench_rand(unsigned n)
+{
+    // xorshift64,the corpora come out the same on every run
+    bench_rng ^= bench_rng << 13;
+    bench_rng ^= bench_rng >> 7;
+    bench_rng ^= bench_rng << 17;
+    return (unsigned)(bench_rng % n);
+}
+
+static const char *bench_words[] = {"int", "return", "buffer", "row", "while", "the", "cursor", "if",
+                                    "render", "0x1f", "42", "3.14", "editor", "for", "char", "static"};
+#define BENCH_WORDS (sizeof(bench_words) / sizeof(bench_words[0]))
+
+static long long bench_words_line(FILE *f, int words, const char *eol)
+{
+    long long n = 0;
+    int i;
+    for (i = 0; i < words; i++)
+    {
+        n += fprintf(f, "%s%s", i ? " " : "", bench_words[bench_rand(BENCH_WORDS)]);
+    }
+    return n + fprintf(f, "%s", eol);
+}
+
+// Ordinary source-like lines
+static void bench_gen_huge(FILE *f, long long bytes)
+{
+    long long n = 0;
+    while (n < bytes)
+    {
+        n += bench_words_line(f, 3 + bench_rand(14), "\n");
+    }
+}
+
+// A few lines of a megabyte each
+static void bench_gen_longlines(FILE *f, long long bytes)
+{
+    long long n = 0, line = 0;
+    while (n < bytes)
+    {
+        line += bench_words_line(f, 1 + bench_rand(3), "");
+        if (line >= (1 << 20) || n + line >= bytes)
+        {
+            fputc('\n', f);
+            n += line + 1;
+            line = 0;
+        }
+        else
+        {
+            fputc(' ', f);
+            line++;
+        }
+    }
+}
+
+// Indentation and alignment with tabs everywhere
+static void bench_gen_tabs(FILE *f, long long bytes)
+{
+    long long n = 0;
+    while (n < bytes)
+    {
+        int depth = bench_rand(8), i;
+        for (i = 0; i < depth; i++)
+        {
+            fputc('\t', f);
+        }
+        n += depth + fprintf(f, "%s\t=\t%s;\t\t// %s\t%s\n", bench_words[bench_rand(BENCH_WORDS)],
+                             bench_words[bench_rand(BENCH_WORDS)], bench_words[bench_rand(BENCH_WORDS)],
+                             bench_words[bench_rand(BENCH_WORDS)]);
+    }
+}
+
+// Block comments that open on one line and close many lines later,with comment openers,
+// strings and line comments inside them
+static void bench_gen_comments(FILE *f, long long bytes)
+{
+    long long n = 0;
+    while (n < bytes)
+    {
+        int lines = 1 + bench_rand(64), i;
+        n += fprintf(f, "/* %d /* /* \"not a string\n", lines);
+        for (i = 0; i < lines && n < bytes; i++)
+        {
+            n += fprintf(f, "%*s/* ", 2 * (i % 16), "");
+            n += bench_words_line(f, 2 + bench_rand(6), " // still a comment\n");
+        }
+        n += fprintf(f, "*/ int x = \"/* %d */\"; // done\n", lines);
+        n += bench_words_line(f, 6, "\n");
+    }
+}
+
+// Windows line endings
+static void bench_gen_crlf(FILE *f, long long bytes)
+{
+    long long n = 0;
+    while (n < bytes)
+    {
+        n += bench_words_line(f, 3 + bench_rand(14), "\r\n");
+    }
+}
+
+struct bench_corpus
+{
+    const char *name;
+    void (*gen)(FILE *f, long long bytes);
+};
+
+static const struct bench_corpus bench_corpora[] = {
+    {"huge", bench_gen_huge},
+    {"longlines", bench_gen_longlines},
+    {"tabs", bench_gen_tabs},
+    {"comments", bench_gen_comments},
+    {"crlf", bench_gen_crlf},
+};
+#define BENCH_CORPORA (sizeof(bench_corpora) / sizeof(bench_corpora[0]))
+
+static long long bench_now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Path of corpus i in dir,the .c suffix turns on C highlighting where there is any
+static void bench_corpus_path(char *path, size_t len, const char *dir, int i)
+{
+    snprintf(path, len, "%s/%s.c", dir, bench_corpora[i].name);
+}
+
+static int bench_make_corpus(const char *path, int i, long long bytes)
+{
+    struct stat st;
+    if (stat(path, &st) == 0 && st.st_size >= bytes && st.st_size - bytes < 4096)
+    {
+        return 0; // kept from an earlier run of the same size with -d
+    }
+    FILE *f = fopen(path, "w");
+    if (f == NULL)
+    {
+        return -1;
+    }
+    bench_rng = 88172645463325252ULL + i;
+    bench_corpora[i].gen(f, bytes);
+    return fclose(f);
+}
+
+// Time one kernel on one corpus in a child process,so peak RSS belongs to this measurement alone
+static void bench_measure(const char *suite, const struct bench_kernel *k, const char *corpus, const char *path, long long budget)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        if (k->setup)
+        {
+            k->setup(path);
+        }
+        long long bytes = k->run(path); // warm up
+        long long iters = 0, start = bench_now_ns(), now;
+        do
+        {
+            bytes = k->run(path);
+            iters++;
+            now = bench_now_ns();
+        } while (now - start < budget);
+        struct rusage ru;
+        getrusage(RUSAGE_SELF, &ru);
+        double secs = (now - start) / 1e9;
+        printf("{\"suite\":\"%s\",\"bench\":\"%s\",\"corpus\":\"%s\",\"bytes\":%lld,\"iters\":%lld,"
+               "\"ops_per_sec\":%.3f,\"ns_per_byte\":%.4f,\"mb_per_sec\":%.2f,\"peak_rss_kb\":%ld}\n",
+               suite, k->name, corpus, bytes, iters, iters / secs,
+               bytes ? (now - start) / (double)(iters * bytes) : 0.0,
+               bytes ? iters * bytes / secs / (1 << 20) : 0.0, ru.ru_maxrss);
+        fflush(stdout);
+        _exit(0);
+    }
+    int status;
+    if (pid == -1 || waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        printf("{\"suite\":\"%s\",\"bench\":\"%s\",\"corpus\":\"%s\",\"error\":\"failed\"}\n", suite, k->name, corpus);
+    }
+}
+
+// Remove the temporary corpus directory and any sidecar files the editor left in it
+static void bench_cleanup(const char *dir)
+{
+    DIR *d = opendir(dir);
+    struct dirent *ent;
+    while (d && (ent = readdir(d)) != NULL)
+    {
+        if (strcmp(ent->d_name, ".") && strcmp(ent->d_name, ".."))
+        {
+            unlinkat(dirfd(d), ent->d_name, 0);
+        }
+    }
+    if (d)
+    {
+        closedir(d);
+    }
+    rmdir(dir);
+}
+
+static int bench_main(const char *suite, const struct bench_kernel *kernels, int nkernels, int argc, char *argv[])
+{
+    long long bytes = 16LL << 20, budget = 300 * 1000000LL;
+    const char *only_kernel = NULL, *only_corpus = NULL;
+    char tmp[] = "/tmp/delulu-bench-XXXXXX";
+    char *dir = NULL;
+    int opt, i, j;
+    while ((opt = getopt(argc, argv, "s:d:b:c:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            bytes = (long long)(atof(optarg) * (1 << 20));
+            break;
+        case 'd':
+            dir = optarg;
+            break;
+        case 'b':
+            only_kernel = optarg;
+            break;
+        case 'c':
+            only_corpus = optarg;
+            break;
+        case 't':
+            budget = atoll(optarg) * 1000000LL;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-s MB] [-d dir] [-b kernel] [-c corpus] [-t ms]\n", argv[0]);
+            return 2;
+        }
+    }
+    int keep = dir != NULL;
+    if (dir == NULL && (dir = mkdtemp(tmp)) == NULL)
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+    mkdir(dir, 0700);
+    for (j = 0; j < (int)BENCH_CORPORA; j++)
+    {
+        char path[4096];
+        if (only_corpus && strcmp(only_corpus, bench_corpora[j].name))
+        {
+            continue;
+        }
+        bench_corpus_path(path, sizeof(path), dir, j);
+        if (bench_make_corpus(path, j, bytes) == -1)
+        {
+            perror(path);
+            return 1;
+        }
+        for (i = 0; i < nkernels; i++)
+        {
+            if (only_kernel == NULL || strcmp(only_kernel, kernels[i].name) == 0)
+            {
+                bench_measure(suite, &kernels[i], bench_corpora[j].name, path, budget);
+            }
+        }
+    }
+    if (!keep)
+    {
+        bench_cleanup(dir);
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+// Microbenchmarks for the hot paths of delulu.c,see bench.h for the options
+#define DELULU_NO_MAIN
+#include "../delulu.c"
+#include "bench.h"
+
+// What editor_init sets up,minus the terminal
+void bench_delulu_reset()
+{
+    int j;
+    for (j = 0; j < E.numrows; j++)
+    {
+        editorFreerow(&E.row[j]);
+    }
+    free(E.row);
+    editor_undo_journal_close();
+    editor_blocks_free(&E.blocks);
+    free(E.lines.tree);
+    free(E.wrap.index.tree);
+    free(E.folds.f);
+    free(E.folds.hidden);
+    free(E.cursors.c);
+    for (j = 0; j < DELULU_KILL_RING; j++)
+    {
+        editor_kill_free(j);
+    }
+    free(E.filename);
+    memset(&E, 0, sizeof(E));
+    E.screenrows = 24;
+    E.screencols = 80;
+    E.swap.fd = -1;
+    E.undo.jfd = -1;
+    E.undo.last = -1;
+}
+
+void bench_delulu_load(const char *path)
+{
+    bench_delulu_reset();
+    editor_open((char *)path);
+}
+
+long long bench_delulu_size()
+{
+    long long n = 0;
+    int j;
+    for (j = 0; j < E.numrows; j++)
+    {
+        n += E.row[j].size;
+    }
+    return n;
+}
+
+// Without the index cache,which the previous iteration would otherwise have left behind
+long long bench_open(const char *path)
+{
+    char *idx = editor_cache_path(path);
+    if (idx)
+    {
+        unlink(idx);
+        free(idx);
+    }
+    bench_delulu_load(path);
+    return E.disk.st_size;
+}
+
+// With the index cache written by the warm up run
+long long bench_open_cached(const char *path)
+{
+    bench_delulu_load(path);
+    return E.disk.st_size;
+}
+
+// Tab expansion into render
+long long bench_update_rows(const char *path)
+{
+    int j;
+    (void)path;
+    for (j = 0; j < E.numrows; j++)
+    {
+        editor_UpdateRows(&E.row[j]);
+    }
+    return bench_delulu_size();
+}
+
+long long bench_rowtostring(const char *path)
+{
+    int len;
+    (void)path;
+    free(editor_rowtostring(&len));
+    return len;
+}
+
+static const struct bench_kernel kernels[] = {
+    {"open", NULL, bench_open},
+    {"open_cached", NULL, bench_open_cached},
+    {"update_rows", bench_delulu_load, bench_update_rows},
+    {"rowtostring", bench_delulu_load, bench_rowtostring},
+};
+
+int main(int argc, char *argv[])
+{
+    bench_delulu_reset();
+    setenv("DELULU_CACHE", "1", 0); // open_cached needs the index cache,open removes it each time
+    return bench_main("delulu", kernels, sizeof(kernels) / sizeof(kernels[0]), argc, argv);
+}
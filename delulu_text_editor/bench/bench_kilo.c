@@ -0,0 +1,52 @@
+// Microbenchmarks for the syntax highlighter and search of Real_code.c,which delulu.c
+// doesn't have yet. See bench.h for the options.
+#define KILO_NO_MAIN
+#include "../Real_code.c"
+#include "bench.h"
+
+void bench_kilo_load(const char *path)
+{
+    E.screenrows = 24;
+    E.screencols = 80;
+    editorOpen((char *)path);
+}
+
+long long bench_kilo_size()
+{
+    long long n = 0;
+    int j;
+    for (j = 0; j < E.numrows; j++)
+    {
+        n += E.row[j].rsize;
+    }
+    return n;
+}
+
+long long bench_update_syntax(const char *path)
+{
+    int j;
+    (void)path;
+    for (j = 0; j < E.numrows; j++)
+    {
+        editorUpdateSyntax(&E.row[j]);
+    }
+    return bench_kilo_size();
+}
+
+// A query that never matches: every search goes through the whole file
+long long bench_find(const char *path)
+{
+    (void)path;
+    editorFindCallback("#no such text#", 0);
+    return bench_kilo_size();
+}
+
+static const struct bench_kernel kernels[] = {
+    {"update_syntax", bench_kilo_load, bench_update_syntax},
+    {"find", bench_kilo_load, bench_find},
+};
+
+int main(int argc, char *argv[])
+{
+    return bench_main("kilo", kernels, sizeof(kernels) / sizeof(kernels[0]), argc, argv);
+}
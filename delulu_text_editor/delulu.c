@@ -1,936 +1,6213 @@
-// Includes
-#define _DEFAULT_SOURCE
-#define _BSED_SOURCE
-#define _GNU_SOURCE // These 3 maros are specifically defined for getline() ,may or maynot be used but good habbit to add them here
-#include <ctype.h>  // For iscntrl function
-#include <errno.h>  // For error handling
-#include <fcntl.h>
-#include <stdio.h>
-#include <stdlib.h>    // For exit function
-#include <stdarg.h>
-#include <sys/ioctl.h> // For terminal control IOCTL->ip/op ctrl to get window size
-#include <termios.h>   // For terminal control
-#include <unistd.h>
-#include <string.h>    // For string manipulation functions
-#include <sys/types.h> //For memory functions
-#include <time.h>
-
-// Defines
-#define delulu_VERSION "0.0.1"   // Version of the text editor
-#define DELULU_TAB_STOP 8
-#define DELULU_QUIT_TIMES 3
-#define CTRL_KEY(k) ((k) & 0x1f) // Macro to convert a control key to its ASCII value
-
-enum editor_key
-{
-    // This enum defines the keys used in the editor
-    BACKSPACE=127,     //
-    ARROW_LEFT = 1000, // Left arrow key
-    ARROW_RIGHT,       // Right arrow key
-    ARROW_UP,          // Up arrow key
-    ARROW_DOWN,        // Down arrow key
-    DEL_KEY,           // Delete key <esc>[3~ in VT100
-    HOME_KEY,          // Home key <esc>[1~ ,[7~,[H,OH in VT100>
-    END_KEY,           // End key <esc>[4~ ,[8~,[F,OF in VT100>
-    PAGE_UP,           // Page up key <esc>[5~ in VT100>
-    PAGE_DOWN,         // Page down key <esc>[6~ in VT100>
-};
-// data
-
-typedef struct erow
-{
-    int size,rsize;
-    char *chars,*render;
-} erow;
-
-//  struct termios original_termios; // To store original terminal attributes
-struct editor_config
-{
-    // This struct holds the editor configuration
-    int cx, cy;                      // Cursor position (x, y)
-    int rx;
-    int rowoff;                     // Row offset for scrolling
-    int coloff;                     // Column offset for scrolling
-    int screenrows;                  // Number of rows in the terminal
-    int screencols;                  // Number of columns in the terminal
-    struct termios original_termios; // To store original terminal attributes
-    int numrows;
-    // erow row;
-    //To store multiple lines we make erow array of erow structs 
-    erow *row; // Array of rows in the editor
-    int dirty;
-    char *filename;
-    char statusmsg[80];
-    time_t statusmsg_time;
-    struct termios orig_termios;
-}E; // Global variable to hold editor configuration
-
-/*prototypes*/
-void editor_setstatus_Message(const char *fmt,...);
-void editor_refressh_screen();
-char *editorPrompt(char *prompt);
-
-// terminal functions
-void die(const char *s)
-{
-    // to clr the screen and move cursor to top-left corner before printing error message
-    write(STDOUT_FILENO, "\x1b[2J", 4); // Clear the screen
-    write(STDOUT_FILENO, "\x1b[H", 3);  // Move cursor to the home position (top-left corner)
-    perror(s);                          // Print error message
-    exit(1);                            // Exit with error code
-}
-
-void reset_terminal_mode()
-{
-    // tcsetattr(STDIN_FILENO, TCSAFLUSH, &original_termios); // Restore original terminal attributes
-    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &E.original_termios) == -1)
-    {
-        die("tcsetattr"); // Restore original terminal attributes on exit
-    }
-}
-
-void set_terminal_raw_mode()
-{
-
-    // tcgetattr(STDIN_FILENO, &original_termios); // Get current terminal attributes
-    if (tcgetattr(STDIN_FILENO, &E.original_termios) == -1)
-    {
-        die("tcgetattr"); // Get current terminal attributes
-    }
-    atexit(reset_terminal_mode); // Ensure original attributes are restored on exit
-
-    struct termios term = E.original_termios; // Copy original attributes to term
-    // DIFFERENT FLAGS
-    //  term.c_lflag &= ~(IXON); // Disable flow control
-    //  //CTRL+S and CTRL+Q are used for flow control, S->XOFF pause tx,Q->XON resume tx,ctrl+S=19 byte & ctrl+Q=17 byte
-    //  term.c_lflag &= ~(IEXTEN|ICANON | ECHO | ISIG); // Disable canonical mode and echo
-    //  //ISIG is used to disable signals like Ctrl+C,ctrl+Z: Now ctrl+c=3 byte & ctrl+z=26 byte
-    //  //IEXTEN is used to disable extended input characters,CTRL+V=22 byte & CTRL+O=15 byte
-    //  term.c_lflag&=~(ICRNL|IXON); // Disable input translation and flow control
-    //  //CR->carriage return,NL->newline,IXON->flow control,ctrl+M=13 byte & enter key=13 byte
-    //  term.c_lflag&=~(OPOST); // Disable output processing
-    //  //OPOST is used to disable output processing which means writing "\r\n" for newline
-    // Misc Flags
-    term.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON); // Disable input flags
-    term.c_oflag &= ~(OPOST);                                  // Disable output flags
-    term.c_cflag |= (CS8);                                     // Set character size to 8 bits
-    term.c_lflag &= ~(IEXTEN | ICANON | ECHO | ISIG);          // Disable canonical mode, echo, and signals
-    // BRKINT when turned pn sent SIGINT signal to program like Ctrl+C
-    // INPCK is used to disable parity checking
-    // ISTRIP is used to disable stripping of high-order bit
-    // CS8 is used to set character size to 8 bits, which is the default
-    term.c_cc[VMIN] = 0;  // Minimum number of characters to read
-    term.c_cc[VTIME] = 1; // Timeout for reading characters (1 decisecond)
-    // c_cc is an array of control characters, which are used to control the terminal behavior
-    // VMIN is the minimum number of characters to read before returning from read()
-    // VTIME is the timeout for reading characters, in deciseconds (0.1 seconds)
-
-    // tcsetattr(STDIN_FILENO, TCSAFLUSH, &term); // Set the new attributes
-    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &term) == -1)
-    {
-        die("tcsetattr"); // Set the new attributes
-    }
-}
-
-int key_read_editor()
-{
-    int nread;
-    char c;
-    while ((nread = read(STDIN_FILENO, &c, 1)) != 1)
-    { // Read a single character from standard input
-        if (nread == -1 && errno != EAGAIN)
-        {                // If read error occurs, handle it
-            die("read"); // Handle read error
-        }
-    }
-    if (c == '\x1b') // If the character is an escape character
-    {
-        char seq[3] = {0};                       // Buffer to hold the escape sequence
-        if (read(STDIN_FILENO, &seq[0], 1) != 1) // Read the next character
-        {
-            return '\x1b'; // If read error occurs, return escape character
-        }
-        if (read(STDIN_FILENO, &seq[1], 1) != 1) // Read the next character
-        {
-            return '\x1b'; // If read error occurs, return escape character
-        }
-        if (seq[0] == '[')
-        {
-            if (seq[1] >= '0' && seq[1] <= '9') // If the second character is a digit
-            {
-                if (read(STDIN_FILENO, &seq[2], 1) != 1) // Read the next character
-                {
-                    return '\x1b'; // If read error occurs, return escape character
-                }
-                if (seq[2] == '~') // If the third character is '~'
-                {
-                    switch (seq[1]) // Check the second character of the escape sequence
-                    {
-                    case '1':
-                        return HOME_KEY; // Home key
-                    case '3':
-                        return DEL_KEY; // Delete key
-                    case '4':
-                        return END_KEY; // End key
-                    case '5':
-                        return PAGE_UP; // Page up key
-                    case '6':
-                        return PAGE_DOWN; // Page down key
-                    case '7':
-                        return HOME_KEY; // Home key
-                    case '8':
-                        return END_KEY; // End key
-                    }
-                }
-            }
-            else
-            {
-                switch (seq[1]) // Check the second character of the escape sequence
-                {
-                case 'A':
-                    return ARROW_UP; // Up arrow key
-                case 'B':
-                    return ARROW_DOWN; // Down arrow key
-                case 'C':
-                    return ARROW_RIGHT; // Right arrow key
-                case 'D':
-                    return ARROW_LEFT; // Left arrow key
-                case 'H':
-                    return HOME_KEY; // Home key
-                case 'F':
-                    return END_KEY; // End key
-                }
-            }
-        }
-        else if (seq[0] == 'O') // If the first character is 'O'
-        {
-            switch (seq[1]) // Check the second character of the escape sequence
-            {
-            case 'H':
-                return HOME_KEY; // Home key
-            case 'F':
-                return END_KEY; // End key
-            }
-        }
-        // If the escape sequence is not recognized, return the escape character
-        return '\x1b';
-    }
-    else
-    {
-        return c; // If the character is not an escape character, return it
-    }
-}
-
-// function to get cursor position mn cmd used to query terminal for status we wanted to give it arg 6 to aks for cursor position
-// then we can read reply from std ip
-int get_cursor_position(int *rows, int *cols)
-{
-    char buf[32];
-    unsigned int i = 0;
-    if (write(STDOUT_FILENO, "\x1b[6n", 4) != 4)
-    {
-        return -1;
-    } // Write escape sequence to request cursor position
-    while (i < sizeof(buf) - 1)
-    { // Read response from terminal
-        if (read(STDIN_FILENO, &buf[i], 1) != 1)
-        {
-            break; // Break if read error occurs
-        }
-        if (buf[i] == 'R')
-        {
-            break; // Break when we reach the end of the response
-        }
-        i++;
-    }
-    buf[i] = '\0'; // Null-terminate the buffer
-    // printf("\r\n&buf[1]: '%s'\r\n",&buf[1]); // Print the response for debugging
-    // //We neglect 1 char which is '\x1b' (escape char) and expect sstrng to end with 0 byte so we make sure to
-    // //assign '\0' to final byte of buf
-    // key_read_editor(); // Wait for a key press to ensure terminal is ready
-    // return -1;
-    if (buf[0] != '\x1b' || buf[1] != '[')
-    {
-        return -1; // If response is not in expected format, return error
-    }
-    if (sscanf(&buf[2], "%d;%d", rows, cols) != 2)
-    {
-        return -1; // If sscanf fails to parse the response, return error
-    }
-    return 0;
-}
-
-int get_window_size(int *rows, int *cols)
-{
-    struct winsize ws;
-    // if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == -1 || ws.ws_col == 0) {
-    //     return -1; // If ioctl fails or terminal size is zero, return error //easy way to get terminal size
-    //}
-    ////if ioctl fails then what can be the strategy to cope witht the situation/hard way
-    /*removing the 1 from the below if condition after working out with the cursor pos and correct no of > */
-    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == -1 || ws.ws_col == 0)
-    {
-        if (write(STDOUT_FILENO, "\x1b[999C\x1b[999B", 12) != 12)
-        {
-            return get_cursor_position(rows, cols);
-        } // C cmd moves cursor to right ,B cmd moves it down,we use big values so that cursor moves to bottom-right corner of terminal
-        // we dont use <esc>[999;999H bcoz it may not work on all terminals,so we use C and B cmd to move cursor to bottom-right corner]
-        // Note: 1 at front test fallback branch we developing
-        // As we always return -1 (meaning error occured)from key_read_editor() function,so we can observe results of esc seq before prog calls die() and clr screen
-
-        key_read_editor(); // Wait for a key press to ensure terminal is ready
-        return -1;
-    }
-    *rows = ws.ws_row; // Get number of rows
-    *cols = ws.ws_col; // Get number of columns
-    return 0;
-}
-
-/* row operations*/
-int editor_rowcxtorx(erow *row,int cx){
-    int rx=0,j;
-    for(j=0;j<cx;j++){
-        if(row->chars[j]=='\t'){
-            rx +=(DELULU_TAB_STOP-1)-(rx%DELULU_TAB_STOP);
-        }
-        rx++;
-    }
-    return rx;
-}
-
-void editor_UpdateRows(erow *row){
-    int tabs=0;
-    int j;
-    for(j=0;j<row->size;j++){
-        if(row->chars[j]=='\t'){
-            tabs++;
-        }
-    }
-    free(row->render);
-    row->render=malloc(row->size+tabs*(DELULU_TAB_STOP-1)+1);
-    int idx=0;
-    for(j=0;j<row->size;j++){
-        if(row->chars[j]=='\t'){
-            row->render[idx++]=' ';
-            while(idx % DELULU_TAB_STOP !=0){
-                row->render[idx++]=' ';
-            }
-        }else{
-            row->render[idx++]=row->chars[j];
-        }
-    }
-    row->render[idx]='\0';
-    row->rsize=idx;
-}
-
-void editor_AppendRows(int at,char *s,size_t len){
-    if(at<0||at>E.numrows){
-        return;
-    }
-    E.row=realloc(E.row,sizeof(erow)*(E.numrows+1)); // Reallocate memory for the rows array
-    memmove(&E.row[at++],&E.row[at],sizeof(erow)*(E.numrows-at));
-    //int at = E.numrows; // Get the current number of rows
-    E.row[at].size = len; // Set the size of the new row
-    E.row[at].chars = malloc(len + 1); // Allocate memory for the
-    // characters in the new row
-    memcpy(E.row[at].chars, s, len); // Copy the characters from the
-    E.row[at].chars[len] = '\0'; // Null-terminate the string
-    E.row[at].rsize=0;//Contains size of contents of render string
-    E.row[at].render=NULL;
-    editor_UpdateRows(&E.row[at]);
-    E.numrows++; // Increment the number of rows
-    E.dirty++;
-
-}
-
-void editorFreerow(erow *row){
-    free(row->render);
-    free(row->chars);
-}
-
-void editor_RowinsertChar(erow *row,int at,int c){
-    if(at<0||at>row->size){
-        at=row->size;
-    }
-    row->chars=realloc(row->chars,row->size+2);
-    memmove(&row->chars[at+1],&row->chars[at],row->size-at+1); //comes from string same like mmcpy but safer 
-    row->size++;
-    row->chars[at]=c;
-    editor_UpdateRows(row);
-    E.dirty++;
-}
-
-void editor_rowdelchar(erow *row,int at){
-    if(at<0||at>=row->size){
-        return;
-    }
-    editorFreerow(&E.row[at]);
-    memmove(&row->chars[at],&row->chars[at+1],row->size-at);
-    row->size--;
-    editor_UpdateRows(row);
-    E.dirty++;
-}
-
-/*editor operations*/
-void editor_insertchar(int c){
-    if(E.cy==E.numrows){
-        editor_AppendRows(E.numrows,"",0);
-    }
-    editor_RowinsertChar(&E.row[E.cy],E.cx,c);
-    E.cx++;
-}
-
-void editor_insertNEwline(){
-    if(E.cx==0){
-        editor_AppendRows(E.cy,"",0);
-    }else{
-        erow *row=&E.row[E.cy];
-        editor_AppendRows(E.cy+1,&row->chars[E.cx],row->size-E.cx);
-        row=&E.row[E.cy];
-        row->size=E.cx;
-        row->chars[row->size]='\0';
-        editor_UpdateRows(row);
-    }
-    E.cy++;
-    E.cx=0;
-}
-
-void editor_delchar(){
-    if(E.cy==E.numrows){
-        return;
-    }
-    if(E.cx==0&&E.cy==0){
-        return;
-    }
-    erow *row=&E.row[E.cy];
-    if(E.cx>0){
-        editor_rowdelchar(row,E.cx-1);
-        E.cx--;
-    }else{
-        E.cx=E.row[E.cy-1].size;
-        editorRowAppendString(&E.row[E.cy-1],row->chars,row->size);
-        editor_rowdelchar(row,E.cy);
-        E.cy--;
-    }
-}
-
-void editorRowAppendString(erow *row,char *s,size_t len){
-    row->chars=realloc(row->chars,row->size+len+1);
-    memcpy(&row->chars[row->size],s,len);
-    row->size+=len;
-    row->chars[row->size]='\0';
-    editor_UpdateRows(row);
-    E.dirty++;
-}
-
-/*File i/o */
-void *editor_rowtostring(int *buflen){
-    int totlen=0;
-    int j;
-    for(j=0;j<E.numrows;j++){
-        totlen+=E.row[j].size+1;
-    }
-    *buflen=totlen;
-    char *buf=malloc(totlen);
-    char *p=buf;
-    for(j=0;j<E.numrows;j++){
-        memcpy(p,E.row[j].chars,E.row[j].size);
-        p += E.row[j].size;
-        *p ='\n';
-        p++;
-    }
-    return buf;
-}
-
-void editor_open(char *filename)
-{ // Will open and read file from disk
-    free(E.filename);
-    E.filename=strdup(filename);
-    FILE *fp = fopen(filename, "r");
-    if (!fp)
-    {
-        die("fopen");
-    }
-    // char *line="Hello to Delulu";
-    // ssize_t linelen=15;
-    char *line = NULL;
-    ssize_t linecap = 0;
-    ssize_t linelen;
-    // linelen = getline(&line, &linecap, fp);
-    // if (linelen != -1)
-    // {
-    //     while (linelen > 0 && (line[linelen - 1] == '\n') || (line[linelen - 1] == '\r'))
-    //     {
-    //         linelen--;
-    //     }
-    //     editor_AppendRows(line,linelen); // Append the line to the editor rows
-    // }
-    while((linelen=getline(&line,&linecap,fp))!=-1){
-        while(linelen>0 && (line[linelen-1]=='\n' || line[linelen-1]=='\r')){
-            linelen--; // Remove trailing newline or carriage return
-        }
-        editor_AppendRows(E.numrows,line,linelen); // Append the line to the editor rows
-    }
-    free(line);
-    fclose(fp);
-    E.dirty=0;
-}
-
-void editor_save(){
-    if(E.filename==NULL){
-        E.filename=editorPrompt("Save as: %s (ESC to cancel)");
-        if(E.filename==NULL){
-            editor_setstatus_Message("Save aborted");
-            return;
-        }
-    }
-    int len;
-    char *buf=editor_rowtostring(&len);
-    int fd =open(E.filename,O_RDWR|O_CREAT,0644);
-    if(fd!=-1){
-        if(ftruncate(fd,len)!=-1){
-            if(write(fd,buf,len)==len){
-                close(fd);
-                free(buf);
-                E.dirty=0;
-                editor_setstatus_Message("%d bytes written to disk",len);
-                return;
-            }
-        }close(fd);
-    }
-    free(buf);
-    editor_setstatus_Message("Can't save I/O error: %s",strerror(errno));
-    //O_RDWR -> for read and write
-    //O_CREAT -> extra arg to contain mode(the permission) the new file should have 
-    //0644 -> std permissions
-}
-
-/*Append Buffer*/
-// This section is for handling the append buffer, which is used to efficiently build strings for output
-struct abuf
-{
-    char *b; // Pointer to the buffer
-    int len; // Length of the buffer
-};
-#define ABUF_INIT {NULL, 0} // Initialize the append buffer
-// append buff consist of ptr to our buff mem and length ,we defined
-// abuf_init const representing empty buffer which acts as constructor
-void ab_append(struct abuf *ab, const char *s, int len)
-{
-    char *new = realloc(ab->b, ab->len + len); // Reallocate memory for the buffer
-    if (new == NULL)
-    {
-        return; // If memory allocation fails, do nothing
-    }
-    memcpy(&new[ab->len], s, len); // Copy the new string into the buffer
-    ab->b = new;                   // Update the buffer pointer
-    ab->len += len;                // Update the length of the buffer
-}
-
-void ab_free(struct abuf *ab)
-{
-    free(ab->b);  // Free the memory allocated for the buffer
-    ab->b = NULL; // Set the pointer to NULL to avoid dangling pointer
-    ab->len = 0;  // Reset the length to 0
-}
-
-// output functions
-void editor_scroll(){
-    E.rx=0;
-    if(E.cy<E.numrows){
-        E.rx=editor_rowcxtorx(&E.row[E.cy],E.cx);
-    }
-    if(E.cy < E.rowoff) {
-        E.rowoff = E.cy; // If the cursor is above the visible area, adjust the row offset
-    }
-    if(E.cy >= E.rowoff + E.screenrows) {
-        E.rowoff = E.cy - E.screenrows + 1; // If the cursor is below the visible area, adjust the row offset
-    }
-    if(E.rx<E.coloff){
-        E.coloff=E.rx;
-    }
-    if(E.rx>=E.coloff + E.screencols){
-        E.coloff = E.rx - E.screencols +1;
-    }
-}
-
-// This function draws the rows of the editor to the append buffer
-void editor_draw_rows(struct abuf *ab)
-{
-    // This function would draw the rows of the editor
-    int y;
-    for (y = 0; y < E.screenrows; y++)
-    {
-        int filerow = y + E.rowoff; // Calculate the row to be drawn based on the offset
-        if (filerow >= E.numrows)
-        {
-            if (E.numrows == 0 && y == E.screenrows / 3)
-            {
-                char welcome[80];
-                int welcome_note = snprintf(welcome, sizeof(welcome), "Delulu Editor - Version %s", delulu_VERSION);
-                int welcomelen = strlen(welcome); // Get the length of the welcome message
-                if (welcomelen > E.screencols)
-                {
-                    welcomelen = E.screencols; // Limit the length to the number of columns
-                }
-                int padding = (E.screencols - welcomelen) / 2; // Calculate padding for centering
-                if (padding)
-                {
-                    ab_append(ab, "~", 1); // Draw the first row with a tilde
-                    // 1 byte long ~ -> tilde char
-                    padding--; // Decrease padding after adding tilde
-                }
-                while (padding--)
-                {
-                    ab_append(ab, " ", 1); // Add spaces for padding
-                    // 1 byte long space -> space char
-                }
-                ab_append(ab, welcome, welcomelen); // Append the welcome message to the buffer
-                // 11 bytes long delulu_VERSION -> version of the text editor
-            }
-            else
-            {
-                ab_append(ab, "~", 1); // Draw the first row with a tilde
-                // 3 bytes long >\r\n -> ~ char,carriage return and newline
-                // \r is carriage return (ASCII 13) and \n is newline (ASCII
-            }
-        }
-        else
-        {
-            int len = E.row[filerow].rsize - E.coloff; // Get the length of the row
-            if(len < 0)
-            {
-                len = 0; // If the length is negative, set it to 0
-            }
-            if (len > E.screencols)
-            {
-                len = E.screencols;
-            }
-            ab_append(ab,&E.row[filerow].render[E.coloff], len);
-        }
-        ab_append(ab, "\x1b[K", 3); // Clear the line
-        // 3 bytes long \x1b[K -> escape sequence to clear the line
-        // for the last line in text editor, we don't want to print a >
-        // if (y < E.screenrows - 1)
-        // {
-        ab_append(ab, "\r\n", 2); // Move to the next line
-            // 2 bytes long \r\n -> carriage return and newline
-        //}
-    }
-}
-
-void editor_draw_StatusBar(struct abuf *ab){
-ab_append(ab,"\x1b[7m]",4);
-char status[80],rstatus[80];
-int len=snprintf(status,sizeof(status),"%.20s - %d lines %s",E.filename ? E.filename :"[No Name]",E.numrows,E.dirty ?"(modified)":"");
-int rlen=snprintf(rstatus,sizeof(rstatus),"%d/%d",E.cy+1,E.numrows);
-if(len>E.screencols) len = E.screencols;
-ab_append(ab,status,len);
-while(len<E.screencols){
-    if(E.screencols-len == rlen){
-        ab_append(ab,rstatus,rlen);
-        break;
-    }else{
-        ab_append(ab," ",1);
-        len++;
-    }
-}
-ab_append(ab,"x1b[m",3);
-ab_append(ab,"\r\n",2);
-}
-
-void editor_draw_MessageBar(struct abuf *ab){
-    ab_append(ab,"\x1b[K",3);
-    int msglen=strlen(E.statusmsg);
-    if(msglen>E.screencols){
-        msglen=E.screencols;
-    }
-    if(msglen&&time(NULL)-E.statusmsg_time<5){
-        ab_append(ab,E.statusmsg,msglen);
-    }
-}
-
-void editor_refressh_screen()
-{
-    editor_scroll(); // Scroll the editor if necessary
-    struct abuf ab = ABUF_INIT;     // Initialize the append buffer
-    ab_append(&ab, "\x1b[?25l", 6); // Hide the cursor
-    // 6 bytes long \x1b[?25l -> escape sequence to hide the cursor
-    // ab_append(&ab,"\x1b[2J", 4); // 4 means we write 4 byt out to terminal,1 byte \x1b ->esc char or 27 in decimal,3 bytes [2J
-    // esc seq strt with esc char 27 followed by [ char
-    // J cmd to clr the screen,arg 2 says clr entrire screen
-    //<esc>[1] clr screen upto where cursor is
-    //<esc>[0] clr screen from cursor to end of screen
-    // 0 default arg for J,so <esc>[J clr screen from cursor to end of screen
-    // We using VT100 esc seq
-    //<esc>[2J cmd left cursor at bottom of screen,so we need to move it to top-left corner to draw editor from top to bottom
-    ab_append(&ab, "\x1b[H", 3); // Move cursor to the home position (top-left corner)
-    // 3 bytes long H ->position cursor ,takes 2 arg-row no and col no at which cursor should be placed
-    // example :- <esc>[5;10H moves cursor to 5th row and 10th column
-    // default is 1,1 which is top-left corner of screen
-    // rows,col no starts from 1 not 0,so <esc>[H is same as <esc>[1;1H
-    editor_draw_rows(&ab); // Draw the rows of the editor
-    editor_draw_StatusBar(&ab);
-    editor_draw_MessageBar(&ab);
-    char buf[32];
-    snprintf(buf,sizeof(buf),"\x1b[%d;%dH",(E.cy-E.rowoff)+1,(E.rx - E.coloff)+1);
-    // 32 bytes long buf -> buffer to hold the cursor position escape sequence
-    // snprintf is used to format the string with cursor position
-    // E.cy and E.cx are the current cursor position in the editor
-    // E.cy is the row number and E.cx is the column number
-    // We add 1 to both E.cy and E.cx because the escape sequence uses 1-based indexing
-    // 1 byte \x1b -> escape char,2 bytes [d;dH -> row no and col no at which cursor should be placed
-    ab_append(&ab,buf,strlen(buf)); // Append the cursor position escape sequence to the buffer
-    // strlen(buf) returns the length of the formatted string in buf
-    // 1 byte \x1b -> escape char,2 bytes [d;dH -> row no and col no at which cursor should be placed
-    // write(STDOUT_FILENO, ab.b, ab.len); // Write the buffer to standard output
-    // 1 byte \x1b -> escape char,2 bytes [d;dH -> row no and col no at which cursor should be placed
-    // ab.b is the pointer to the buffer and ab.len is the length of the buffer
-    ab_append(&ab,"\x1b[?25l",6);
-    write(STDOUT_FILENO,ab.b,ab.len); // Move cursor back to the home position (top-left corner)
-    ab_free(&ab);                       // Free the append buffer memory
-}
-
-void editor_setstatus_Message(const char*fmt,...){
-    va_list ap;
-    va_start(ap,fmt);
-    vsnprintf(E.statusmsg,sizeof(E.statusmsg),fmt,ap);
-    va_end(ap);
-    E.statusmsg_time=time(NULL);
-}
-// input functions
-char *editorPrompt(char *prompt){
-    size_t bufsize=128;
-    char *buf=malloc(bufsize);
-    size_t buflen=0;
-    buf[0]='\0';
-    while(1){
-        editor_setstatus_Message(prompt,buf);
-        editor_refressh_screen();
-        int c =key_read_editor();
-        if(c==DEL_KEY||c==CTRL_KEY('h')||c==BACKSPACE){
-            if(buflen!=0){
-                buf[--buflen]='\0';
-            }
-        }
-        else if(c=='\x1b'){
-            editor_setstatus_Message("");
-            free(buf);
-            return NULL;
-        }else if(c=='\r'){
-            if(buflen!=0){
-                editor_setstatus_Message("");
-                return buf;
-            }
-        }else if(!iscntrl(c)&&c<128){
-            if(buflen==bufsize-1){
-                bufsize*=2;
-                buf=realloc(buf,bufsize);
-            }
-            buf[buflen++]=c;
-            buf[buflen]='\0';
-        }
-    }
-}
-
-void editor_move_cursor(int key)
-{
-    erow *row =(E.cy>=E.numrows) ? NULL :&E.row[E.cy];
-    switch (key) // This function moves the cursor based on the key pressed
-    {
-    case ARROW_LEFT:
-        if (E.cx != 0)
-        {
-            E.cx--; // Move cursor left
-        }else if(E.cy>0){
-            E.cy--;
-            E.cx=E.row[E.cy].size;//Allowing user to press <- at begining of line to move to end of previous line
-        }
-        break;
-    case ARROW_RIGHT:
-        // if (E.cx < E.screencols - 1)
-        // {
-        //     // E.cx < E.screencols - 1 to prevent cursor from moving beyond
-        //     E.cx++; // Move cursor right
-        // }
-        if(row && E.cx <row->size){
-        E.cx++;}else if(row&&E.cx==row->size){
-            E.cy++;
-            E.cx=0; //Allowing user to to press -> at end of line 
-        }
-        break;
-    case ARROW_UP:
-        if (E.cy != 0)
-        {
-            // E.cy!=0 to prevent cursor from moving beyond the top of the screen
-            E.cy--; // Move cursor up
-        }
-        break;
-    case ARROW_DOWN:
-        if (E.cy < E.numrows)
-        {
-            // E.cy < E.screenrows - 1 to prevent cursor from moving beyond the bottom
-            E.cy++; // Move cursor down
-        }
-        break;
-    }
-    row=(E.cy>=E.numrows) ?NULL:&E.row[E.cy];
-    int rowlen=row?row->size:0;
-    if(E.cx>rowlen){
-        E.cx=rowlen;
-    }
-}
-
-void editor_process_keypress()
-{
-    static int quit_times=DELULU_QUIT_TIMES;
-    int c = key_read_editor(); // Read a single character from standard input
-    switch (c)                 // Process the character
-    {
-    case '\r':
-        /*TODO*/
-        editor_insertNEwline();
-        break;
-    case CTRL_KEY('q'):                     // If Ctrl+Q is pressed
-        if(E.dirty && quit_times>0){
-            editor_setstatus_Message("WARNING!!! File has unsaved changes."
-            "Press Ctrl+q %d more times to quit.",quit_times);
-            quit_times--;
-            return;
-        }
-        write(STDOUT_FILENO, "\x1b[2J", 4); // Clear the screen
-        write(STDOUT_FILENO, "\x1b[H", 3);  // Move cursor to the home position (top-left corner)
-        exit(0);                            // Exit the program
-        break;
-    case CTRL_KEY('s'):
-        editor_save();
-        break;
-    case HOME_KEY: // If Home key is pressed
-        E.cx = 0;  // Move cursor to the beginning of the line
-        break;
-    case END_KEY:                // If End key is pressed
-        if(E.cy<E.numrows){
-            E.cx = E.row[E.cy].size; // Move cursor to the end
-        }
-        break;
-    case BACKSPACE:
-    case CTRL_KEY('h'):
-    case DEL_KEY:
-        if(c==DEL_KEY){
-            editor_move_cursor(ARROW_RIGHT);
-        }
-        editor_delchar();
-        break;
-    case PAGE_UP:
-    case PAGE_DOWN:
-    {
-        if(c==PAGE_UP){
-            E.cy=E.rowoff;
-        }else if(c==PAGE_DOWN){
-            E.cy=E.rowoff+E.screenrows-1;
-            if(E.cy>E.numrows){
-                E.cy=E.numrows;
-            }
-        }
-        int times = E.screenrows; // Number of rows to move the cursor
-        while (times--)
-        {
-            editor_move_cursor(c == PAGE_UP ? ARROW_UP : ARROW_DOWN); // Move the cursor up or down based on the key pressed
-        }
-    }
-    case ARROW_UP:
-    case ARROW_DOWN:
-    case ARROW_LEFT:
-    case ARROW_RIGHT:
-        editor_move_cursor(c); // Move the cursor based on the key pressed
-        break;
-    case CTRL_KEY('l'):
-    case '\x1b':
-        break;
-    default:
-        editor_insertchar(c);
-        break;
-    }
-    quit_times=DELULU_QUIT_TIMES;
-}
-
-// init
-void editor_init()
-{
-    // This function initializes the editor configuration
-    E.cx = 0;      // Initialize cursor x position
-    E.cy = 0;      // Initialize cursor y position
-    E.rx=0;
-    E.rowoff = 0;  // Initialize row offset for scrolling
-    E.coloff = 0;  // Initialize column offset for scrolling
-    E.numrows = 0; // Initialize num of rows
-    E.row=NULL;  //Initialise rows to NULL
-    E.dirty=0;
-    E.filename=NULL;
-    E.statusmsg[0]='\0';
-    E.statusmsg_time=0;
-    // Initialize the editor configuration
-    if (get_window_size(&E.screenrows, &E.screencols) == -1)
-    {
-        die("get_window_size");
-    }
-    E.screenrows -=2;
-}
-
-int main(int argc, char *argv[])
-{
-    set_terminal_raw_mode(); // Set terminal to raw mode
-    editor_init();           // Its job is to initialize the editor configuration, including getting the terminal size
-    if (argc >= 2)
-    {
-        editor_open(argv[1]);
-    }
-    // Read characters from standard input until 'p' is pressed
-    // char c;
-    // while(read(STDIN_FILENO,&c,1)==1 && (c!='p')){ //read file until p is not triggered
-    //     // printf("%s ",&c); to check the input
-    //     if(iscntrl(c)){
-    //         printf("%d\r\n", c); // Print control character as its ASCII value
-    //     }else{
-    //         printf("%d ('%c')\r\n",c, c); // Print regular character
-    //     }
-    // }
-    editor_setstatus_Message("HELP: Ctrl+S=save | Ctrl+Q=quit");
-    while (1)
-    {
-        // char c='\0';
-
-        // // read(STDIN_FILENO, &c, 1); // Read a single character from standard input
-        // if(read(STDIN_FILENO, &c, 1)==-1 && errno!=EAGAIN){ // Read a single character from standard input
-        //     die("read"); // Handle read error
-        // }
-
-        // if(iscntrl(c)){ // Check if the character is a control character
-        //     printf("%d\r\n", c); // Print control character as its ASCII value
-        // } else {
-        //     printf("%d ('%c')\r\n", c, c); // Print regular character with its ASCII value
-        // }
-        // // }if(c=='p'){ // If 'p' is pressed, exit the loop
-        // //     break; // Exit the loop
-        // // }
-        // if(c == CTRL_KEY('q')) { // If Ctrl+Q is pressed, exit the loop
-        //     break; // Exit the loop
-        // }
-        editor_refressh_screen();  // Refresh the screen
-        editor_process_keypress(); // Process keypresses
-    }
-    return 0;
-}
-
-/* This program sets the terminal to raw mode, reads characters from standard input,
- and prints their ASCII values. It handles control characters differently by printing their ASCII values.
- tcsetattr(), read(),tcgetattr() are system calls used to control terminal behavior ;if return -1, it indicates an error occurred, and we handle it using the die() function which prints the error message and exits the program.
- CTRL_KEY macro bitwise-ANDs a char with val 00011111,in binary, which effectively converts a control key to its ASCII value. For example, CTRL_KEY('a') would yield 1 (0x01), CTRL_KEY('b') would yield 2 (0x02), and so on. 
- This allows us to easily check for control key combinations in the input handling loop.Ctrl key in terminal strips 5 & 6 bits from whatever key is pressed and send that
- key_read_editor job is to wait for 1 keypress and return it, later we expand func to handle escape seq,involving multiple bytes representing single keypresses like arrow keys, function keys, etc.
- The editor_process_keypress waits for keypress & then handles it,later it'll map various Ctrl combinations & other special keys to diff editor funct,& insert any alphanumeric characters and other printable keys char into text thats being edited
- editor_process_keypress belongs in {terminal} section bcoz it deals with low-level terminal ip,whereas editor_process_keypress is more about handling user input and processing key presses in the context of an editor.
- The separation allows for better organization of code,making it easier to maintain and extend functionality in the future.
- */
-
+// Includes
+#define _DEFAULT_SOURCE
+#define _BSED_SOURCE
+#define _GNU_SOURCE // These 3 maros are specifically defined for getline() ,may or maynot be used but good habbit to add them here
+#include <ctype.h>  // For iscntrl function
+#include <errno.h>  // For error handling
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>    // For exit function
+#include <stdarg.h>
+#include <sys/ioctl.h> // For terminal control IOCTL->ip/op ctrl to get window size
+#include <sys/inotify.h> // For follow mode
+#include <sys/mman.h>  // For mapping the undo journal
+#include <sys/stat.h>
+#include <sys/uio.h>   // For writev of swap records
+#include <sys/xattr.h> // For keeping ACLs when saving
+#include <signal.h>
+#include <stddef.h>    // For offsetof
+#include <limits.h>
+#include <pthread.h>   // For the background save thread
+#include <poll.h>      // For the event loop
+#include <termios.h>   // For terminal control
+#include <unistd.h>
+#include <string.h>    // For string manipulation functions
+#include <sys/types.h> //For memory functions
+#include <time.h>
+
+// Defines
+#define delulu_VERSION "0.0.1"   // Version of the text editor
+#define DELULU_TAB_STOP 8
+#define DELULU_QUIT_TIMES 3
+#define DELULU_UNDO_BUDGET (16<<20)   // Bytes of undo log kept in memory before old actions are dropped
+#define DELULU_UNDO_COALESCE_MAX 4096 // Longest run of typing folded into a single undo record
+#define DELULU_SWAP_INTERVAL 1000     // ms between fsyncs of the crash-recovery swap file
+#define DELULU_SWAP_BATCH (64<<10)    // Swap records batched in memory before a write
+#define DELULU_SAVE_CHUNK (1<<20)     // Bytes the save thread gathers per write
+#define DELULU_ESC_TIMEOUT 50         // ms to wait for the rest of an escape sequence
+#define DELULU_INPUT_RING 4096        // Bytes of terminal input buffered,a power of two
+#define DELULU_SEQ_MAX 32             // Longest escape sequence the decoder waits for
+#define DELULU_PROGRESS_INTERVAL 100  // ms between status bar updates while saving
+#define DELULU_PASTE_TIMEOUT 1000     // ms a bracketed paste may stall before it is taken as finished
+#define DELULU_FPS 60                 // Redraws per second at most,DELULU_FPS in the environment overrides,0 = no cap
+#define DELULU_FRAME_MAX_DELAY 250    // ms a redraw may be held back by input that keeps arriving
+#define DELULU_FRAMES 4               // Frame buffers shared with the render thread,a power of two
+#define DELULU_HIST_SUB 16            // Histogram buckets per power of two,about 6% resolution
+#define DELULU_HIST_BUCKETS (64 * DELULU_HIST_SUB)
+#define DELULU_VIEW_BLOCK (64<<10)    // Bytes per block the viewer (-R) reads with pread
+#define DELULU_VIEW_BLOCKS 64         // Blocks it keeps,least recently used goes first
+#define DELULU_VIEW_READ (1<<20)      // Bytes the viewer's line indexer reads at a time
+#define DELULU_VIEW_STRIDE 1024       // Lines between offsets in the viewer's line index,to start with
+#define DELULU_VIEW_INDEX_MAX (1<<16) // Offsets in the line index,the stride doubles when it fills
+#define DELULU_FOLLOW_CHUNK (1<<20)   // Bytes follow mode (-F) appends between frames
+#define DELULU_DISK_BLOCK_ROWS 256    // Lines per block of the file's change-detection hashes,on average
+#define DELULU_DISK_BLOCK_ROWS_MAX 4096 // and at most
+#define DELULU_DISK_CHECK_INTERVAL 2000 // ms between checks whether the file changed on disk
+#define DELULU_CACHE_MIN (1<<20)      // Files smaller than this open fast enough without an index cache
+#define DELULU_CACHE_SAMPLES 16       // 4 KB pieces of the file hashed to check that its index cache is current
+#define DELULU_KILL_RING 16           // Line cuts and copies kept for pasting
+#define DELULU_TRACE_EVENTS (1<<16)   // Trace events kept when built with -DDELULU_TRACE,a power of two
+#define DELULU_HASH_INIT 14695981039346656037ULL // FNV-1a offset basis for editor_hash
+#define CTRL_KEY(k) ((k) & 0x1f) // Macro to convert a control key to its ASCII value
+
+enum editor_key
+{
+    // This enum defines the keys used in the editor
+    BACKSPACE=127,     //
+    ARROW_LEFT = 1000, // Left arrow key
+    ARROW_RIGHT,       // Right arrow key
+    ARROW_UP,          // Up arrow key
+    ARROW_DOWN,        // Down arrow key
+    DEL_KEY,           // Delete key <esc>[3~ in VT100
+    HOME_KEY,          // Home key <esc>[1~ ,[7~,[H,OH in VT100>
+    END_KEY,           // End key <esc>[4~ ,[8~,[F,OF in VT100>
+    PAGE_UP,           // Page up key <esc>[5~ in VT100>
+    PAGE_DOWN,         // Page down key <esc>[6~ in VT100>
+    INSERT_KEY,        // Insert key <esc>[2~
+    BACKTAB,           // Shift+Tab <esc>[Z
+    F1_KEY,            // Function keys <esc>OP..<esc>OS,<esc>[11~..<esc>[24~
+    F2_KEY,
+    F3_KEY,
+    F4_KEY,
+    F5_KEY,
+    F6_KEY,
+    F7_KEY,
+    F8_KEY,
+    F9_KEY,
+    F10_KEY,
+    F11_KEY,
+    F12_KEY,
+    PASTE_START,       // Bracketed paste markers <esc>[200~ and <esc>[201~
+    PASTE_END,
+    FOCUS_IN,          // Focus reporting <esc>[I and <esc>[O
+    FOCUS_OUT,
+    REDRAW_EVENT,      // Not a key: something other than input wants the screen redrawn
+    PASTE_EVENT,       // Not a key: a whole bracketed paste is waiting in E.paste
+};
+
+enum undo_type
+{
+    // Delta records kept in the undo log,each one is the smallest description of a row mutation
+    UNDO_INSERT_CHARS = 1, // bytes inserted into a row at col
+    UNDO_DELETE_CHARS,     // bytes removed from a row at col
+    UNDO_INSERT_ROW,       // new row inserted at row
+    UNDO_DELETE_ROW,       // row removed at row
+    UNDO_INSERT_ROWS,      // col rows inserted at row,payload is their text joined by '\n'
+    UNDO_DELETE_ROWS,      // col rows removed at row,same payload
+};
+#define UNDO_GROUP_START (1<<0) // First record of a user action
+#define UNDO_NOPAYLOAD (1<<1)   // Insert too big to keep,only its extent is stored so it can be undone but not redone
+
+#define UNDO_JOURNAL_MAGIC "DLUNDO1"  // 8 bytes with the terminating 0
+#define UNDO_JOURNAL_HDR 64           // Records start after the header
+#define UNDO_JOURNAL_CHUNK (1<<20)    // Journal file grows in steps of this many bytes
+#define UNDO_NOT_SAVED ((size_t)-1)   // No history offset matches the file on disk
+
+enum undo_kind
+{
+    // What the current keypress does,consecutive keypresses of the same kind coalesce
+    UNDO_KIND_OTHER = 0,
+    UNDO_KIND_TYPING,
+    UNDO_KIND_DELETE,
+};
+#define KEY_SHIFT 0x10000 // Modifier bits or'ed into a key,decoded from xterm sequences
+#define KEY_ALT 0x20000
+#define KEY_CTRL 0x40000
+#define KEY_MODS (KEY_SHIFT | KEY_ALT | KEY_CTRL)
+// data
+
+struct editor_input
+{
+    // Ring of bytes read from the terminal but not decoded yet
+    unsigned char buf[DELULU_INPUT_RING];
+    size_t head, tail; // Free-running counters,index with & (DELULU_INPUT_RING-1)
+};
+
+struct editor_paste
+{
+    // Text of the last bracketed paste,reused from one paste to the next
+    char *buf;
+    size_t len, cap;
+};
+
+struct undo_rec
+{
+    // Fixed header of one undo record,followed by len payload bytes and a 4 byte record size
+    unsigned char type, flags;
+    unsigned short pad;
+    int row, col;   // Where the mutation happened
+    unsigned int len; // Bytes inserted or deleted
+    int cx, cy;     // Cursor before the action
+    int acx, acy;   // Cursor after the action (stamped on the last record of a group)
+};
+
+struct undo_journal_hdr
+{
+    // First UNDO_JOURNAL_HDR bytes of the journal file
+    char magic[8];
+    unsigned long long key;   // editor_hash of the file contents that match offset saved
+    unsigned long long saved; // History offset matching the file on disk or UNDO_NOT_SAVED
+    unsigned long long first; // Oldest history offset kept in the journal
+    unsigned long long end;   // End of valid records
+    char pad[24];
+};
+
+#define SWAP_MAGIC "DLSWAP1"
+struct swap_hdr
+{
+    // Header of the swap file,delta records in undo_rec format follow
+    char magic[8];
+    unsigned long long key; // editor_hash of the file contents the records apply to
+    char pad[16];
+};
+
+struct editor_swap
+{
+    int fd;         // Swap file or -1 until the first edit
+    char *buf;      // Records not written yet
+    size_t len,cap;
+    off_t off;      // File offset of the next record
+    int unsynced;   // Written but not fsync'd yet
+    long long last_sync;
+    unsigned long long key;
+    int replaying;  // Recovering,don't log the replayed edits again
+    int failed;     // A write failed: the swap misses edits,so it is off for the rest of the session
+};
+
+struct editor_undo
+{
+    char *log;      // Contiguous record log,holds history offsets [base,len)
+    size_t cap;     // Allocated bytes
+    size_t base;    // History offset of log[0],older records are only in the journal
+    size_t len;     // End of history
+    size_t pos;     // Undo point,records past it are the redo tail
+    size_t group;   // Offset of the group being recorded
+    long last;      // Offset of the newest record or -1
+    int start;      // Next record opens a new group
+    int coalesce;   // Next record may merge into the previous one
+    int kind;       // undo_kind of the previous keypress
+    int skip;       // Current action is not recorded
+    int replaying;  // Mutations come from undo/redo themselves
+    int disabled;   // Mutations are not edits (e.g. loading a file)
+    int jfd;        // Journal file or -1
+    int jlazy;      // No journal file yet,the first edit creates it
+    char *jmap;     // Journal mapping,NULL until first needed
+    size_t jmaplen;
+    size_t jfirst;  // Oldest offset in the journal
+    size_t jsaved;  // Offset matching the file on disk
+    size_t synced;  // Journal holds every record below this offset
+    unsigned long long jkey; // Content hash at jsaved
+};
+
+struct rowbuf
+{
+    // Header in front of every row's chars and render,lets snapshots and the kill ring share them
+    int refs;    // Rows and snapshots pointing at chars
+    size_t cap;  // Bytes allocated for chars
+    long long disk; // File offset where chars and its newline already are,-1 if not on disk
+    char chars[];
+};
+
+struct disk_block
+{
+    // A run of lines of the file on disk
+    unsigned long long hash; // of their bytes,newlines included
+    long long off, len;
+    int rows;
+};
+
+struct editor_blocks
+{
+    struct disk_block *b;
+    int n, cap;
+    int closed; // The last block is complete
+};
+
+#define CACHE_MAGIC "DLIDX02"
+struct cache_hdr
+{
+    // Header of the index cache (editor_cache_path),followed by rows+1 line start offsets and the
+    // change-detection blocks
+    char magic[8];
+    unsigned long long size, dev, ino, mtime_sec, mtime_nsec; // The file it describes
+    unsigned long long sample; // editor_cache_sample of that file
+    unsigned long long key;    // editor_hash of its contents,what editor_open would compute
+    long long rows, blocks;
+    int partial;               // The last line has no newline
+    int cy, cx, rowoff, coloff; // Where the cursor was
+    char pad[28];
+};
+
+struct editor_save_job
+{
+    // A save running on the writer thread
+    int active;
+    pthread_t thread;
+    char *filename;
+    struct { char *chars; int size; long long disk,newoff; } *rows; // Snapshot of the row table,chars are shared
+    int numrows;
+    long long total,written; // Bytes,written is updated by the thread as it goes
+    long long rewritten;     // Bytes that went through write rather than being left or copied in place
+    int inplace;             // Modified rows were patched into the existing file
+    int disk_ok;             // disk describes the file the row offsets refer to
+    struct stat disk;        // Identity of the file on disk,updated after the save
+    int done,err;            // Set by the thread when finished
+    unsigned long long key;  // editor_hash of what was written
+    int dirty;               // E.dirty at the snapshot
+    size_t upos;             // Undo history offset at the snapshot
+    off_t swapoff;           // Swap file offset at the snapshot,-1 if there was no swap file yet
+    struct editor_blocks blocks; // Change-detection blocks of what was written
+};
+
+struct frame_queue
+{
+    // Single-producer single-consumer ring of frames,lock free: head is only written by the
+    // producer and tail only by the consumer
+    struct abuf *slot[DELULU_FRAMES];
+    size_t head, tail;
+};
+
+struct editor_render
+{
+    // The render thread writes composed frames to the terminal so the edit thread never waits on output
+    int running;
+    pthread_t thread;
+    int pipe[2];              // Wakes the render thread
+    struct frame_queue ready; // Composed frames,edit thread -> render thread
+    struct frame_queue free;  // Frames handed back for reuse,render thread -> edit thread
+    int frames;               // Frame buffers allocated so far
+    int starved;              // The edit thread found no free frame and wants a wakeup when one comes back
+    int stop;
+    long long dropped;        // Frames replaced by a newer one before they were drawn
+    int sync;                 // Terminal supports synchronized output (DEC mode 2026)
+};
+
+struct editor_hist
+{
+    // Log-linear (HDR style) histogram of nanosecond values,recording is a couple of stores
+    unsigned long long count[DELULU_HIST_BUCKETS];
+    unsigned long long n, max;
+};
+
+struct editor_perf
+{
+    // Always-on performance counters behind the HUD (F12) and the dump (Shift+F12)
+    struct editor_hist latency;  // Key read to the frame showing it written to the terminal
+    struct editor_hist keypress; // Handling one key
+    struct editor_hist frame;    // Composing one frame
+    long long last_latency;
+    long long key_at;            // editor_now_ns() of the oldest key not in a frame yet,0 if none
+    long long key_read;          // When the key being handled was read
+    int rows_rendered;           // editor_UpdateRows calls since the last frame
+    int frame_rows, frame_bytes; // What the last frame took
+    int hud;
+};
+
+struct view_block
+{
+    // A cached DELULU_VIEW_BLOCK of the file being viewed
+    off_t off;
+    int len;
+    unsigned long long used; // E.view.clock when last used
+    char *data;
+};
+
+struct editor_view
+{
+    // Read-only viewer (-R),the file is paged in block by block and never loaded into E.row
+    int active;
+    int fd;
+    off_t size;
+    struct view_block block[DELULU_VIEW_BLOCKS];
+    unsigned long long clock;
+    off_t top;      // Offset of the first line on screen
+    long long line; // Its line number
+    int exact;      // line is known,not estimated
+    char *buf;      // Line bytes and their rendering for one screen row
+    int bufcap;
+    // Line index,written by the indexer thread under lock
+    pthread_t thread;
+    pthread_mutex_t lock;
+    int indexing;   // The indexer was started and not joined yet
+    int done;       // Set by the indexer when finished
+    off_t *index;   // index[j] is the offset of line j*stride
+    int nindex;
+    long long stride;
+    long long lines; // Newlines counted in the first indexed bytes
+    off_t indexed;
+    long long total; // Lines in the file once indexing finished,-1 before
+};
+
+struct editor_follow
+{
+    // Follow mode (-F): rows are appended as the file grows
+    int active;
+    int fd;        // inotify
+    int file;      // The file being followed
+    dev_t dev;     // Its identity,a different one at the same path means it was rotated
+    ino_t ino;
+    off_t off;     // Bytes of it already in the rows
+    int partial;   // The last row had no newline yet
+    int more;      // There may be more to read
+    char *buf;
+};
+
+struct row_index
+{
+    // Fenwick tree over a count per row: the sum up to a row and the row at a sum in O(log n).
+    // Inserting or deleting rows shifts the ones after them,so the tree is only kept up to the
+    // first such row and rebuilt from there when next asked.
+    long long *tree; // tree[i] sums rows (i-(i&-i),i],1-based
+    int cap;
+    int valid;       // tree[1..valid] is up to date
+};
+
+struct editor_wrap
+{
+    // Soft wrap (Ctrl+W): long rows continue on the next screen lines instead of scrolling sideways
+    int on;
+    int width;       // Screen columns the rows are laid out for
+    int sub;         // Visual line of row E.rowoff at the top of the screen
+    struct row_index index; // Visual lines per row
+};
+
+struct fold_range
+{
+    int start, end; // Rows start+1..end are hidden behind row start
+};
+
+struct editor_folds
+{
+    // Closed folds,sorted and disjoint
+    struct fold_range *f;
+    int *hidden; // hidden[i] rows are hidden by the folds before f[i],n+1 of them
+    int n, cap;
+};
+
+struct editor_cursor
+{
+    int cy, cx;
+    int main; // The one in E.cy/E.cx,only while editor_cursors_edit works on all of them
+};
+
+struct editor_cursors
+{
+    // Cursors besides E.cy/E.cx,sorted by row and column,none on the same place
+    struct editor_cursor *c;
+    int n, cap;
+    int col; // Render column Alt+Up/Down puts new cursors in
+};
+
+typedef struct erow
+{
+    int size,rsize;
+    char *chars,*render;
+    int *wrap;       // Render offsets where its visual lines after the first start
+    int wraps,wrapw; // Visual lines and the width they were laid out for,wrapw 0 = not laid out
+} erow;
+
+struct editor_kill
+{
+    // Ring of whole-line cuts and copies. Their rows share chars and render with the row table,
+    // cutting moves the rows here and pasting shares them back.
+    struct { erow *rows; int n; } ring[DELULU_KILL_RING];
+    int last, count; // Newest entry and how many there are
+    int marking, mark; // Alt+A started a line selection at row mark
+    int yanked, yank_at, yank_n, yank_i; // Rows the last Ctrl+U put in and from which entry,for Alt+Y
+};
+
+//  struct termios original_termios; // To store original terminal attributes
+struct editor_config
+{
+    // This struct holds the editor configuration
+    int cx, cy;                      // Cursor position (x, y)
+    int rx;
+    int rowoff;                     // Row offset for scrolling
+    int coloff;                     // Column offset for scrolling
+    int screenrows;                  // Number of rows in the terminal
+    int screencols;                  // Number of columns in the terminal
+    struct termios original_termios; // To store original terminal attributes
+    int numrows;
+    // erow row;
+    //To store multiple lines we make erow array of erow structs 
+    erow *row; // Array of rows in the editor
+    int dirty;
+    char *filename;
+    char statusmsg[80];
+    time_t statusmsg_time;
+    long long statusmsg_expire; // editor_now_ms() when the message bar should clear,0 if nothing shown
+    int wakefd[2];             // Self-pipe waking the event loop for signals and the save thread
+    volatile sig_atomic_t resized; // SIGWINCH arrived
+    int redraw;                // The screen is out of date
+    int frame_ms;              // Shortest time between redraws
+    long long frame_at;        // editor_now_ms() of the last redraw
+    struct editor_input in;    // Terminal input not yet decoded
+    struct editor_paste paste;
+    struct termios orig_termios;
+    struct editor_undo undo;
+    struct editor_swap swap;
+    struct editor_save_job save;
+    struct editor_render render;
+    struct editor_perf perf;
+    struct editor_view view;
+    struct editor_follow follow;
+    struct row_index lines;    // Byte offsets of the rows
+    struct editor_wrap wrap;
+    struct editor_folds folds;
+    struct editor_cursors cursors;
+    struct editor_kill kill;
+    struct stat disk;  // The file as last read or written,row disk offsets refer to it
+    int disk_ok;
+    char *disk_path;   // The path disk was taken from
+    struct editor_blocks blocks; // Its lines in hashed blocks,to tell what another program changed
+    int disk_changed;  // Changed on disk under unsaved edits: 1 = warned,2 = Ctrl+S again overwrites
+    long long disk_check_at; // editor_now_ms() of the last check
+}E; // Global variable to hold editor configuration
+
+/*prototypes*/
+void editor_setstatus_Message(const char *fmt,...);
+void editor_refressh_screen();
+char *editorPrompt(char *prompt);
+void editor_edit_record(int type,int row,int col,const char *s,size_t len);
+void editor_undo_record(int type,int row,int col,const char *s,size_t len);
+void editor_swap_record(int type,int row,int col,const char *s,size_t len);
+void editor_swap_tick();
+void editor_swap_flush(int sync);
+int editor_save_tick();
+int editor_view_tick();
+int editor_follow_tick();
+void editor_follow_drain();
+int editor_disk_check();
+void editor_blocks_add(struct editor_blocks *bl,const char *s,size_t len,int nl);
+void editor_blocks_free(struct editor_blocks *bl);
+void editor_disk_path(const char *path);
+int editor_cache_load(const char *filename,FILE *fp,unsigned long long *key);
+void editor_cache_write(const char *filename,const long long *offs,long long rows,int partial,unsigned long long key);
+char *editor_cache_path(const char *filename);
+int editor_cache_enabled();
+long long editor_wrap_count(int row);
+void editor_wrap_layout(int j,long long counted);
+void editor_wrap_resize();
+void editor_fold_rows(int at,int delta);
+void editor_fold_clear();
+void editor_cursors_rows(int at,int delta);
+void editor_kill_rows(int at,int delta);
+void editor_kill_disk();
+void editor_cursors_edit(const char *s,size_t len,int dir);
+void editor_cursors_clear();
+void editor_move_cursor(int key);
+long long editor_now_ms();
+int get_window_size(int *rows, int *cols);
+void editor_undo_truncate();
+void editor_undo_flush();
+int editor_undo_journal_map(size_t need);
+void editor_undo_journal_reset();
+void editor_render_stop();
+FILE *editor_dump_open(const char *path, int tmp);
+
+/*trace*/
+// Built with -DDELULU_TRACE (make delulu_trace) the pipeline stages record Chrome trace events
+// into a ring. SIGUSR1 writes it out,so does exiting with DELULU_TRACE_FILE set; load the file
+// in chrome://tracing or Perfetto. Without DELULU_TRACE the macros expand to nothing.
+#ifdef DELULU_TRACE
+struct trace_event
+{
+    const char *name; // NULL while the slot is being written
+    long long ts, dur; // ns
+    int tid;
+};
+
+struct editor_trace
+{
+    struct trace_event ev[DELULU_TRACE_EVENTS];
+    unsigned long long next; // Events ever recorded,the ring keeps the last DELULU_TRACE_EVENTS
+    volatile sig_atomic_t dump; // SIGUSR1 arrived
+} Trace;
+
+long long editor_trace_now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// A stage that ran from start until now. Main and render thread both record,each takes its own slot.
+void editor_trace_event(const char *name, long long start)
+{
+    long long now = editor_trace_now();
+    unsigned long long i = __atomic_fetch_add(&Trace.next, 1, __ATOMIC_RELAXED) & (DELULU_TRACE_EVENTS - 1);
+    struct trace_event *e = &Trace.ev[i];
+    __atomic_store_n(&e->name, NULL, __ATOMIC_RELAXED);
+    e->ts = start;
+    e->dur = now - start;
+    e->tid = E.render.running && pthread_equal(pthread_self(), E.render.thread) ? 2 : 1;
+    __atomic_store_n(&e->name, name, __ATOMIC_RELEASE);
+}
+
+int editor_trace_write(const char *path, int tmp)
+{
+    FILE *fp = editor_dump_open(path, tmp);
+    unsigned long long end = __atomic_load_n(&Trace.next, __ATOMIC_ACQUIRE), i;
+    unsigned long long start = end > DELULU_TRACE_EVENTS ? end - DELULU_TRACE_EVENTS : 0;
+    int pid = getpid();
+    if (fp == NULL)
+    {
+        return -1;
+    }
+    fprintf(fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":1,\"args\":{\"name\":\"main\"}},\n", pid);
+    fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":2,\"args\":{\"name\":\"render\"}}", pid);
+    for (i = start; i < end; i++)
+    {
+        struct trace_event *e = &Trace.ev[i & (DELULU_TRACE_EVENTS - 1)];
+        const char *name = __atomic_load_n(&e->name, __ATOMIC_ACQUIRE);
+        if (name)
+        {
+            fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}", name,
+                    e->ts / 1e3, e->dur / 1e3, pid, e->tid);
+        }
+    }
+    fprintf(fp, "\n]}\n");
+    fclose(fp);
+    return 0;
+}
+
+// Where the trace goes: DELULU_TRACE_FILE or /tmp/delulu-trace.<pid>.json,returns 1 for the latter
+int editor_trace_path(char *path, size_t len)
+{
+    char *env = getenv("DELULU_TRACE_FILE");
+    if (env)
+    {
+        snprintf(path, len, "%s", env);
+        return 0;
+    }
+    snprintf(path, len, "/tmp/delulu-trace.%d.json", (int)getpid());
+    return 1;
+}
+
+void editor_trace_signal(int sig)
+{
+    (void)sig;
+    Trace.dump = 1;
+    if (write(E.wakefd[1], "t", 1) == -1)
+    {
+        // pipe full: a wakeup is already pending
+    }
+}
+
+// Called from the event loop: write the trace if SIGUSR1 asked for it
+void editor_trace_poll()
+{
+    if (Trace.dump)
+    {
+        char path[256];
+        Trace.dump = 0;
+        int tmp = editor_trace_path(path, sizeof(path));
+        if (editor_trace_write(path, tmp) == 0)
+        {
+            editor_setstatus_Message("Trace written to %s", path);
+        }
+        else
+        {
+            editor_setstatus_Message("Can't write %s: %s", path, strerror(errno));
+        }
+        E.redraw = 1; // show it
+    }
+}
+
+void editor_trace_atexit()
+{
+    char path[256];
+    int tmp = editor_trace_path(path, sizeof(path));
+    editor_trace_write(path, tmp);
+}
+
+void editor_trace_init()
+{
+    signal(SIGUSR1, editor_trace_signal);
+    if (getenv("DELULU_TRACE_FILE"))
+    {
+        atexit(editor_trace_atexit);
+    }
+}
+
+#define TRACE_BEGIN(t) long long t = editor_trace_now()
+#define TRACE_END(t, name) editor_trace_event(name, t)
+#define TRACE_POLL() editor_trace_poll()
+#define TRACE_INIT() editor_trace_init()
+#else
+#define TRACE_BEGIN(t)
+#define TRACE_END(t, name)
+#define TRACE_POLL()
+#define TRACE_INIT()
+#endif
+
+// terminal functions
+void die(const char *s)
+{
+    if (E.render.running && !pthread_equal(pthread_self(), E.render.thread))
+    {
+        editor_render_stop(); // Let queued output out before the error
+    }
+    // to clr the screen and move cursor to top-left corner before printing error message
+    write(STDOUT_FILENO, "\x1b[2J", 4); // Clear the screen
+    write(STDOUT_FILENO, "\x1b[H", 3);  // Move cursor to the home position (top-left corner)
+    perror(s);                          // Print error message
+    if (E.swap.buf)
+    {
+        editor_swap_flush(1); // Keep unsaved edits recoverable
+    }
+    exit(1);                            // Exit with error code
+}
+
+void reset_terminal_mode()
+{
+    // tcsetattr(STDIN_FILENO, TCSAFLUSH, &original_termios); // Restore original terminal attributes
+    write(STDOUT_FILENO, "\x1b[?2004l\x1b[?1004l", 16); // Bracketed paste and focus reporting off
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &E.original_termios) == -1)
+    {
+        die("tcsetattr"); // Restore original terminal attributes on exit
+    }
+}
+
+void set_terminal_raw_mode()
+{
+
+    // tcgetattr(STDIN_FILENO, &original_termios); // Get current terminal attributes
+    if (tcgetattr(STDIN_FILENO, &E.original_termios) == -1)
+    {
+        die("tcgetattr"); // Get current terminal attributes
+    }
+    atexit(reset_terminal_mode); // Ensure original attributes are restored on exit
+
+    struct termios term = E.original_termios; // Copy original attributes to term
+    // DIFFERENT FLAGS
+    //  term.c_lflag &= ~(IXON); // Disable flow control
+    //  //CTRL+S and CTRL+Q are used for flow control, S->XOFF pause tx,Q->XON resume tx,ctrl+S=19 byte & ctrl+Q=17 byte
+    //  term.c_lflag &= ~(IEXTEN|ICANON | ECHO | ISIG); // Disable canonical mode and echo
+    //  //ISIG is used to disable signals like Ctrl+C,ctrl+Z: Now ctrl+c=3 byte & ctrl+z=26 byte
+    //  //IEXTEN is used to disable extended input characters,CTRL+V=22 byte & CTRL+O=15 byte
+    //  term.c_lflag&=~(ICRNL|IXON); // Disable input translation and flow control
+    //  //CR->carriage return,NL->newline,IXON->flow control,ctrl+M=13 byte & enter key=13 byte
+    //  term.c_lflag&=~(OPOST); // Disable output processing
+    //  //OPOST is used to disable output processing which means writing "\r\n" for newline
+    // Misc Flags
+    term.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON); // Disable input flags
+    term.c_oflag &= ~(OPOST);                                  // Disable output flags
+    term.c_cflag |= (CS8);                                     // Set character size to 8 bits
+    term.c_lflag &= ~(IEXTEN | ICANON | ECHO | ISIG);          // Disable canonical mode, echo, and signals
+    // BRKINT when turned pn sent SIGINT signal to program like Ctrl+C
+    // INPCK is used to disable parity checking
+    // ISTRIP is used to disable stripping of high-order bit
+    // CS8 is used to set character size to 8 bits, which is the default
+    term.c_cc[VMIN] = 0;  // Minimum number of characters to read
+    term.c_cc[VTIME] = 0; // No read timeout,waiting is done in poll() (see editor_wait_event)
+    // c_cc is an array of control characters, which are used to control the terminal behavior
+    // VMIN is the minimum number of characters to read before returning from read()
+    // VTIME is the timeout for reading characters, in deciseconds (0.1 seconds)
+    // With both 0 read() returns what is already there,so it never spins waiting for input
+
+    // tcsetattr(STDIN_FILENO, TCSAFLUSH, &term); // Set the new attributes
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &term) == -1)
+    {
+        die("tcsetattr"); // Set the new attributes
+    }
+    write(STDOUT_FILENO, "\x1b[?2004h", 8); // Bracketed paste: pasted text arrives between <esc>[200~ and <esc>[201~
+    write(STDOUT_FILENO, "\x1b[?1004h", 8); // Focus reporting: <esc>[I when the terminal gets focus back
+}
+
+/*event loop*/
+// The editor sleeps in poll() until there is input,a resize or a timer to service,so an idle
+// editor uses no CPU. SIGWINCH and the save thread wake it through a self-pipe (E.wakefd).
+void editor_wake_signal(int sig)
+{
+    (void)sig;
+    E.resized = 1;
+    if (write(E.wakefd[1], "w", 1) == -1)
+    {
+        // pipe full: a wakeup is already pending
+    }
+}
+
+// Shrink *timeout (ms,-1 = forever) so poll returns by deadline
+void editor_timeout_until(int *timeout, long long deadline, long long now)
+{
+    long long left = deadline > now ? deadline - now : 0;
+    if (*timeout == -1 || left < *timeout)
+    {
+        *timeout = (int)left;
+    }
+}
+
+void editor_update_window_size()
+{
+    if (get_window_size(&E.screenrows, &E.screencols) == -1)
+    {
+        die("get_window_size");
+    }
+    E.screenrows -= 2; // Room for the status and message bars
+    editor_wrap_resize();
+}
+
+// Sleep until stdin is readable (returns 0) or something other than input needs the screen
+// redrawn (returns REDRAW_EVENT). Timers for the swap file are serviced on the way.
+int editor_wait_event()
+{
+    while (1)
+    {
+        long long now = editor_now_ms();
+        int timeout = -1; // Nothing scheduled: sleep until input
+        if (E.statusmsg_expire)
+        {
+            editor_timeout_until(&timeout, E.statusmsg_expire, now); // the message bar clears itself
+        }
+        if (E.swap.fd != -1 && (E.swap.len || E.swap.unsynced))
+        {
+            editor_timeout_until(&timeout, E.swap.last_sync + DELULU_SWAP_INTERVAL, now);
+        }
+        if (E.save.active || E.view.indexing)
+        {
+            editor_timeout_until(&timeout, now + DELULU_PROGRESS_INTERVAL, now); // save or indexing progress in the status bar
+        }
+        if (E.redraw && !__atomic_load_n(&E.render.starved, __ATOMIC_ACQUIRE))
+        {
+            editor_timeout_until(&timeout, E.frame_at + E.frame_ms, now); // a frame held back by the rate cap
+        }
+        if (E.follow.more && !E.save.active)
+        {
+            timeout = 0; // more of the followed file to append
+        }
+        if (E.disk_ok)
+        {
+            editor_timeout_until(&timeout, E.disk_check_at + DELULU_DISK_CHECK_INTERVAL, now); // another program may write the file
+        }
+        struct pollfd fds[3] = {{STDIN_FILENO, POLLIN, 0}, {E.wakefd[0], POLLIN, 0}, {E.follow.fd, POLLIN, 0}};
+        int n = poll(fds, E.follow.active ? 3 : 2, timeout);
+        if (n == -1 && errno != EINTR)
+        {
+            die("poll");
+        }
+        if (n > 0 && (fds[1].revents & POLLIN))
+        {
+            char drain[64];
+            while (read(E.wakefd[0], drain, sizeof(drain)) > 0)
+            {
+            }
+            TRACE_POLL();
+        }
+        if (n > 0 && E.follow.active && (fds[2].revents & POLLIN))
+        {
+            editor_follow_drain();
+        }
+        if (E.resized)
+        {
+            E.resized = 0;
+            editor_update_window_size();
+            return REDRAW_EVENT;
+        }
+        if (n > 0 && (fds[0].revents & (POLLIN | POLLHUP | POLLERR)))
+        {
+            return 0;
+        }
+        now = editor_now_ms();
+        editor_swap_tick();
+        int redraw = editor_save_tick(); // progress moved on or the save finished
+        redraw |= editor_view_tick();     // so did the viewer's line index
+        redraw |= editor_follow_tick();   // or the followed file grew
+        if (E.disk_ok && now >= E.disk_check_at + DELULU_DISK_CHECK_INTERVAL)
+        {
+            redraw |= editor_disk_check(); // or another program changed it
+        }
+        if (E.statusmsg_expire && now >= E.statusmsg_expire)
+        {
+            E.statusmsg_expire = 0;
+            redraw = 1;
+        }
+        if (E.redraw && now >= E.frame_at + E.frame_ms)
+        {
+            redraw = 1;
+        }
+        if (redraw)
+        {
+            return REDRAW_EVENT;
+        }
+    }
+}
+
+// Is there more input to handle right now? Keys already typed are processed before the screen
+// is drawn,so a burst of input costs one frame instead of one per key.
+int editor_input_pending()
+{
+    if (E.in.head != E.in.tail)
+    {
+        return 1;
+    }
+    struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+    return poll(&fd, 1, 0) == 1;
+}
+
+// Draw if the screen is out of date,there is no typeahead and the frame rate allows it.
+// Input that never lets up still gets a frame every DELULU_FRAME_MAX_DELAY ms.
+void editor_frame()
+{
+    long long now = editor_now_ms();
+    if (!E.redraw)
+    {
+        return;
+    }
+    if (now - E.frame_at < DELULU_FRAME_MAX_DELAY && editor_input_pending())
+    {
+        return;
+    }
+    if (now - E.frame_at < E.frame_ms)
+    {
+        return; // editor_wait_event wakes up for it when the interval is over
+    }
+    editor_refressh_screen();
+}
+
+// Read one byte of a terminal reply that has started arriving,giving up after timeout ms
+int editor_read_byte(char *c, int timeout)
+{
+    struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+    if (poll(&fd, 1, timeout) != 1)
+    {
+        return 0;
+    }
+    return read(STDIN_FILENO, c, 1) == 1;
+}
+
+/*input*/
+// Keys are decoded from a user-space ring that is filled by large reads,so a burst of typing,
+// a held key or a paste costs one read() per wakeup instead of one per byte.
+// Escape sequences are decoded by a small state machine plus a lookup table (KEY_SEQS):
+// CSI (ESC [ params final) and SS3 (ESC O final),with xterm modifier parameters.
+struct key_seq
+{
+    char intro;  // '[' for CSI,'O' for SS3
+    char final;  // Final byte of the sequence
+    int param;   // First parameter for '~' sequences,0 otherwise
+    int key;
+};
+
+static const struct key_seq KEY_SEQS[] = {
+    {'[', 'A', 0, ARROW_UP}, {'[', 'B', 0, ARROW_DOWN}, {'[', 'C', 0, ARROW_RIGHT}, {'[', 'D', 0, ARROW_LEFT},
+    {'[', 'H', 0, HOME_KEY}, {'[', 'F', 0, END_KEY}, {'[', 'Z', 0, BACKTAB},
+    {'[', 'P', 0, F1_KEY}, {'[', 'Q', 0, F2_KEY}, {'[', 'R', 0, F3_KEY}, {'[', 'S', 0, F4_KEY},
+    {'[', '~', 1, HOME_KEY}, {'[', '~', 2, INSERT_KEY}, {'[', '~', 3, DEL_KEY}, {'[', '~', 4, END_KEY},
+    {'[', '~', 5, PAGE_UP}, {'[', '~', 6, PAGE_DOWN}, {'[', '~', 7, HOME_KEY}, {'[', '~', 8, END_KEY},
+    {'[', '~', 11, F1_KEY}, {'[', '~', 12, F2_KEY}, {'[', '~', 13, F3_KEY}, {'[', '~', 14, F4_KEY},
+    {'[', '~', 15, F5_KEY}, {'[', '~', 17, F6_KEY}, {'[', '~', 18, F7_KEY}, {'[', '~', 19, F8_KEY},
+    {'[', '~', 20, F9_KEY}, {'[', '~', 21, F10_KEY}, {'[', '~', 23, F11_KEY}, {'[', '~', 24, F12_KEY},
+    {'[', '~', 200, PASTE_START}, {'[', '~', 201, PASTE_END}, {'[', 'I', 0, FOCUS_IN}, {'[', 'O', 0, FOCUS_OUT},
+    {'O', 'A', 0, ARROW_UP}, {'O', 'B', 0, ARROW_DOWN}, {'O', 'C', 0, ARROW_RIGHT}, {'O', 'D', 0, ARROW_LEFT},
+    {'O', 'H', 0, HOME_KEY}, {'O', 'F', 0, END_KEY},
+    {'O', 'P', 0, F1_KEY}, {'O', 'Q', 0, F2_KEY}, {'O', 'R', 0, F3_KEY}, {'O', 'S', 0, F4_KEY},
+};
+#define KEY_SEQS_ENTRIES (sizeof(KEY_SEQS) / sizeof(KEY_SEQS[0]))
+
+// Byte i of the unread input,-1 if it hasn't arrived
+int editor_input_peek(size_t i)
+{
+    if (E.in.tail + i >= E.in.head)
+    {
+        return -1;
+    }
+    return E.in.buf[(E.in.tail + i) & (DELULU_INPUT_RING - 1)];
+}
+
+// Length of a terminal reply <esc>[?params[$]final at byte i of the unread input,0 when
+// something else is there and -1 when the input ends before it could tell
+int editor_input_reply(size_t i)
+{
+    size_t n;
+    int c;
+    for (n = 0; (c = editor_input_peek(i + n)) != -1; n++)
+    {
+        if (n < 3)
+        {
+            if (c != "\x1b[?"[n])
+            {
+                return 0;
+            }
+        }
+        else if (c >= 0x40 && c <= 0x7e)
+        {
+            return n + 1;
+        }
+        else if (!isdigit(c) && c != ';' && c != '$')
+        {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Take n bytes out of the unread input at byte i,what comes after them moves up
+void editor_input_drop(size_t i, size_t n)
+{
+    size_t j;
+    for (j = E.in.tail + i; j + n < E.in.head; j++)
+    {
+        E.in.buf[j & (DELULU_INPUT_RING - 1)] = E.in.buf[(j + n) & (DELULU_INPUT_RING - 1)];
+    }
+    E.in.head -= n;
+}
+
+// Read whatever the terminal has into the free part of the ring,returns the number of bytes
+int editor_input_fill()
+{
+    size_t used = E.in.head - E.in.tail;
+    if (used == 0)
+    {
+        E.in.head = E.in.tail = 0; // empty: start over so a single iovec covers the whole ring
+    }
+    size_t space = DELULU_INPUT_RING - used;
+    size_t h = E.in.head & (DELULU_INPUT_RING - 1);
+    size_t first = DELULU_INPUT_RING - h < space ? DELULU_INPUT_RING - h : space;
+    if (space == 0)
+    {
+        return 0;
+    }
+    struct iovec iov[2] = {{&E.in.buf[h], first}, {&E.in.buf[0], space - first}};
+    ssize_t n = readv(STDIN_FILENO, iov, space > first ? 2 : 1);
+    if (n == -1 && (errno == EAGAIN || errno == EINTR))
+    {
+        return 0;
+    }
+    if (n <= 0)
+    {
+        die("read"); // read error or the terminal went away
+    }
+    E.in.head += n;
+    return n;
+}
+
+// Decode one key from the front of the ring. Returns the bytes it took,or 0 when the ring
+// ends in the middle of an escape sequence and more input is needed.
+int editor_decode_key(int *key)
+{
+    enum { DEC_ESC, DEC_INTRO, DEC_PARAM } state = DEC_ESC;
+    int params[4] = {0, 0, 0, 0};
+    int nparams = 0, intro = 0;
+    size_t i;
+    int c = editor_input_peek(0);
+    if (c != '\x1b')
+    {
+        *key = c;
+        return 1;
+    }
+    for (i = 1; i < DELULU_SEQ_MAX; i++)
+    {
+        c = editor_input_peek(i);
+        if (c == -1)
+        {
+            return 0; // sequence still arriving
+        }
+        switch (state)
+        {
+        case DEC_ESC:
+            if (c == '[' || c == 'O')
+            {
+                intro = c;
+                state = DEC_INTRO;
+                break;
+            }
+            if (c == '\x1b')
+            {
+                *key = '\x1b'; // ESC ESC: the first one stands alone
+                return 1;
+            }
+            *key = c | KEY_ALT; // ESC followed by a plain key is how terminals send Alt+key
+            return 2;
+        case DEC_INTRO:
+        case DEC_PARAM:
+            if (c >= '0' && c <= '9')
+            {
+                if (nparams == 0)
+                {
+                    nparams = 1;
+                }
+                params[nparams - 1] = params[nparams - 1] * 10 + (c - '0');
+                state = DEC_PARAM;
+                break;
+            }
+            if (c == ';')
+            {
+                if (nparams == 0)
+                {
+                    nparams = 1;
+                }
+                if (nparams < 4)
+                {
+                    nparams++;
+                }
+                state = DEC_PARAM;
+                break;
+            }
+            if (c >= 0x20 && c <= 0x2f)
+            {
+                break; // intermediate bytes,none of the keys we know use them
+            }
+            if (c >= 0x40 && c <= 0x7e)
+            {
+                // Final byte: look the sequence up and apply the xterm modifier parameter (1 + bits)
+                size_t k;
+                int mod = (c == '~') ? params[1] : (nparams > 1 ? params[1] : 0);
+                *key = '\x1b'; // unknown sequences are swallowed whole
+                for (k = 0; k < KEY_SEQS_ENTRIES; k++)
+                {
+                    if (KEY_SEQS[k].intro == intro && KEY_SEQS[k].final == c &&
+                        KEY_SEQS[k].param == (c == '~' ? params[0] : 0))
+                    {
+                        *key = KEY_SEQS[k].key;
+                        if (mod > 1)
+                        {
+                            mod--;
+                            *key |= ((mod & 1) ? KEY_SHIFT : 0) | ((mod & 2) ? KEY_ALT : 0) | ((mod & 4) ? KEY_CTRL : 0);
+                        }
+                        break;
+                    }
+                }
+                return i + 1;
+            }
+            *key = '\x1b'; // not a sequence after all: ESC alone,the rest is ordinary input
+            return 1;
+        }
+    }
+    *key = '\x1b'; // runaway sequence,drop the ESC
+    return 1;
+}
+
+// Collect a bracketed paste up to <esc>[201~ straight out of the ring into E.paste,
+// so a paste of any size is one event: no per-byte decoding and a single redraw
+int editor_read_paste()
+{
+    static const char end[] = "\x1b[201~";
+    size_t scan = 0;
+    E.paste.len = 0;
+    while (1)
+    {
+        while (E.in.head != E.in.tail)
+        {
+            size_t t = E.in.tail & (DELULU_INPUT_RING - 1);
+            size_t n = E.in.head - E.in.tail;
+            if (n > DELULU_INPUT_RING - t)
+            {
+                n = DELULU_INPUT_RING - t; // the part up to the end of the ring,the rest next time round
+            }
+            if (E.paste.len + n > E.paste.cap)
+            {
+                size_t cap = E.paste.cap ? E.paste.cap * 2 : 64 << 10;
+                while (cap < E.paste.len + n)
+                {
+                    cap *= 2;
+                }
+                char *buf = realloc(E.paste.buf, cap);
+                if (buf == NULL)
+                {
+                    die("realloc");
+                }
+                E.paste.buf = buf;
+                E.paste.cap = cap;
+            }
+            memcpy(&E.paste.buf[E.paste.len], &E.in.buf[t], n);
+            E.paste.len += n;
+            E.in.tail += n;
+            // The end marker may straddle two reads,so look a few bytes back
+            char *p = memmem(&E.paste.buf[scan], E.paste.len - scan, end, sizeof(end) - 1);
+            if (p)
+            {
+                size_t at = p - E.paste.buf;
+                E.in.tail -= E.paste.len - at - (sizeof(end) - 1); // input typed after the paste stays in the ring
+                E.paste.len = at;
+                return PASTE_EVENT;
+            }
+            scan = E.paste.len > sizeof(end) - 2 ? E.paste.len - (sizeof(end) - 2) : 0;
+        }
+        struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+        int r = poll(&fd, 1, DELULU_PASTE_TIMEOUT);
+        if (r == 0)
+        {
+            return PASTE_EVENT; // the terminal never closed the paste,take what came
+        }
+        if (r == 1)
+        {
+            editor_input_fill();
+        }
+    }
+}
+
+int key_read_editor()
+{
+    while (1)
+    {
+        if (E.in.head != E.in.tail)
+        {
+            int key, n = editor_decode_key(&key);
+            if (n > 0)
+            {
+                E.in.tail += n;
+                if (key == PASTE_START)
+                {
+                    return editor_read_paste();
+                }
+                return key;
+            }
+            // Part of an escape sequence is here,give the rest a moment to arrive
+            struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+            if (poll(&fd, 1, DELULU_ESC_TIMEOUT) == 1 && editor_input_fill() > 0)
+            {
+                continue;
+            }
+            E.in.tail = E.in.head; // it never came: a lone ESC,drop the fragment
+            return '\x1b';
+        }
+        TRACE_BEGIN(wait);
+        int ev = editor_wait_event(); // Block until a key arrives or the screen needs attention
+        TRACE_END(wait, "wait");
+        if (ev)
+        {
+            return ev;
+        }
+        editor_input_fill();
+    }
+}
+
+// function to get cursor position mn cmd used to query terminal for status we wanted to give it arg 6 to aks for cursor position
+// then we can read reply from std ip
+int get_cursor_position(int *rows, int *cols)
+{
+    char buf[32];
+    unsigned int i = 0;
+    if (write(STDOUT_FILENO, "\x1b[6n", 4) != 4)
+    {
+        return -1;
+    } // Write escape sequence to request cursor position
+    while (i < sizeof(buf) - 1)
+    { // Read response from terminal
+        if (!editor_read_byte(&buf[i], DELULU_ESC_TIMEOUT * 10))
+        {
+            break; // Break if read error occurs or the terminal doesn't answer
+        }
+        if (buf[i] == 'R')
+        {
+            break; // Break when we reach the end of the response
+        }
+        i++;
+    }
+    buf[i] = '\0'; // Null-terminate the buffer
+    // printf("\r\n&buf[1]: '%s'\r\n",&buf[1]); // Print the response for debugging
+    // //We neglect 1 char which is '\x1b' (escape char) and expect sstrng to end with 0 byte so we make sure to
+    // //assign '\0' to final byte of buf
+    // key_read_editor(); // Wait for a key press to ensure terminal is ready
+    // return -1;
+    if (buf[0] != '\x1b' || buf[1] != '[')
+    {
+        return -1; // If response is not in expected format, return error
+    }
+    if (sscanf(&buf[2], "%d;%d", rows, cols) != 2)
+    {
+        return -1; // If sscanf fails to parse the response, return error
+    }
+    return 0;
+}
+
+int get_window_size(int *rows, int *cols)
+{
+    struct winsize ws;
+    // if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == -1 || ws.ws_col == 0) {
+    //     return -1; // If ioctl fails or terminal size is zero, return error //easy way to get terminal size
+    //}
+    ////if ioctl fails then what can be the strategy to cope witht the situation/hard way
+    /*removing the 1 from the below if condition after working out with the cursor pos and correct no of > */
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == -1 || ws.ws_col == 0)
+    {
+        if (write(STDOUT_FILENO, "\x1b[999C\x1b[999B", 12) != 12)
+        {
+            return get_cursor_position(rows, cols);
+        } // C cmd moves cursor to right ,B cmd moves it down,we use big values so that cursor moves to bottom-right corner of terminal
+        // we dont use <esc>[999;999H bcoz it may not work on all terminals,so we use C and B cmd to move cursor to bottom-right corner]
+        // Note: 1 at front test fallback branch we developing
+        // As we always return -1 (meaning error occured)from key_read_editor() function,so we can observe results of esc seq before prog calls die() and clr screen
+
+        key_read_editor(); // Wait for a key press to ensure terminal is ready
+        return -1;
+    }
+    *rows = ws.ws_row; // Get number of rows
+    *cols = ws.ws_col; // Get number of columns
+    return 0;
+}
+
+/*line index*/
+// Rows from at on were inserted,deleted or replaced
+void editor_index_moved(struct row_index *x,int at){
+    if(at<x->valid){
+        x->valid=at;
+    }
+}
+
+// The count of row at went up by delta
+void editor_index_add(struct row_index *x,int at,long long delta){
+    int i;
+    for(i=at+1;i<=x->valid;i+=i&-i){
+        x->tree[i]+=delta;
+    }
+}
+
+// Bring the tree up to date with E.row,O(rows past the first moved one)
+void editor_index_update(struct row_index *x,long long (*count)(int row)){
+    int n=E.numrows,i,p;
+    if(x->valid>n){
+        x->valid=n; // rows freed without going through the row operations
+    }
+    if(x->valid==n){
+        return;
+    }
+    if(n+1>x->cap){
+        x->cap=n+1>x->cap*2?n+1:x->cap*2;
+        x->tree=realloc(x->tree,sizeof(*x->tree)*x->cap);
+    }
+    for(i=x->valid+1;i<=n;i++){
+        x->tree[i]=count(i-1);
+    }
+    // Linear build: every node adds itself into its parent. The ones still valid that have a
+    // parent past valid are the nodes a prefix sum up to valid visits.
+    for(i=x->valid;i>0;i-=i&-i){
+        if((p=i+(i&-i))<=n){
+            x->tree[p]+=x->tree[i];
+        }
+    }
+    for(i=x->valid+1;i<=n;i++){
+        if((p=i+(i&-i))<=n){
+            x->tree[p]+=x->tree[i];
+        }
+    }
+    x->valid=n;
+}
+
+// Sum of the counts of the rows before at
+long long editor_index_sum(struct row_index *x,long long (*count)(int row),int at){
+    long long sum=0;
+    int i;
+    editor_index_update(x,count);
+    for(i=at;i>0;i-=i&-i){
+        sum+=x->tree[i];
+    }
+    return sum;
+}
+
+// Row whose counts hold the sum v and how far into it,past the end gives E.numrows
+int editor_index_find(struct row_index *x,long long (*count)(int row),long long v,long long *rest){
+    int pos=0,step=1;
+    editor_index_update(x,count);
+    while(step*2<=E.numrows){
+        step*=2;
+    }
+    for(;E.numrows>0&&step>0;step/=2){
+        if(pos+step<=E.numrows&&x->tree[pos+step]<=v){
+            pos+=step;
+            v-=x->tree[pos];
+        }
+    }
+    *rest=v;
+    return pos;
+}
+
+// delta rows were inserted at at,or deleted from there when negative: tell everything kept by row
+void editor_rows_moved(int at,int delta){
+    editor_index_moved(&E.lines,at);
+    editor_index_moved(&E.wrap.index,at);
+    editor_fold_rows(at,delta);
+    editor_cursors_rows(at,delta);
+    editor_kill_rows(at,delta);
+}
+
+long long editor_lines_count(int row){
+    return E.row[row].size+1;
+}
+
+// Offset of row at in the file as it would be saved,E.numrows gives its size
+long long editor_lines_offset(int at){
+    return editor_index_sum(&E.lines,editor_lines_count,at);
+}
+
+// Row holding byte off and its column there
+int editor_lines_row(long long off,long long *col){
+    return editor_index_find(&E.lines,editor_lines_count,off,col);
+}
+
+// Ctrl+G: a line number,@ and a byte offset,or a percentage of the file
+void editor_goto(){
+    char *s=editorPrompt("Go to line, @byte or N%%: %s (ESC to cancel)");
+    if(s==NULL){
+        return;
+    }
+    size_t len=strlen(s);
+    if(s[0]=='@'||s[len-1]=='%'){
+        long long total=editor_lines_offset(E.numrows),col;
+        long long off=s[0]=='@'?atoll(s+1):(long long)(atof(s)*total/100);
+        if(off>=total){
+            off=total>0?total-1:0; // the last newline
+        }
+        E.cy=editor_lines_row(off<0?0:off,&col);
+        E.cx=E.cy<E.numrows&&col<E.row[E.cy].size?col:E.cy<E.numrows?E.row[E.cy].size:0;
+    }else{
+        long long line=atoll(s);
+        E.cy=line<1||E.numrows==0?0:line>E.numrows?E.numrows-1:line-1;
+        E.cx=0;
+    }
+    free(s);
+    E.rowoff=E.cy>E.screenrows/2?E.cy-E.screenrows/2:0; // the target in the middle of the screen
+    E.wrap.sub=0;
+}
+
+/* row operations*/
+int editor_rowcxtorx(erow *row,int cx){
+    int rx=0,j;
+    for(j=0;j<cx;j++){
+        if(row->chars[j]=='\t'){
+            rx +=(DELULU_TAB_STOP-1)-(rx%DELULU_TAB_STOP);
+        }
+        rx++;
+    }
+    return rx;
+}
+
+int editor_rowrxtocx(erow *row,int rx){
+    int cur=0,cx;
+    for(cx=0;cx<row->size;cx++){
+        if(row->chars[cx]=='\t'){
+            cur+=(DELULU_TAB_STOP-1)-(cur%DELULU_TAB_STOP);
+        }
+        cur++;
+        if(cur>rx){
+            return cx;
+        }
+    }
+    return cx;
+}
+
+// Row text and its render live in refcounted buffers so snapshots and the kill ring can share them
+// with the live rows. The count sits in a small header in front of chars; writers go through
+// editor_row_reserve,a render is never changed,only replaced.
+struct rowbuf *editor_rowbuf(char *chars){
+    return (struct rowbuf *)(chars-offsetof(struct rowbuf,chars));
+}
+
+char *editor_chars_alloc(size_t len){
+    struct rowbuf *b=malloc(sizeof(struct rowbuf)+len+1);
+    b->refs=1;
+    b->cap=len+1;
+    b->disk=-1;
+    return b->chars;
+}
+
+char *editor_chars_new(const char *s,size_t len){
+    char *chars=editor_chars_alloc(len);
+    memcpy(chars,s,len);
+    chars[len]='\0';
+    return chars;
+}
+
+char *editor_chars_share(char *chars){
+    struct rowbuf *b=editor_rowbuf(chars);
+    __atomic_add_fetch(&b->refs,1,__ATOMIC_RELAXED);
+    return chars;
+}
+
+void editor_chars_free(char *chars){
+    if(chars==NULL){
+        return;
+    }
+    struct rowbuf *b=editor_rowbuf(chars);
+    if(__atomic_sub_fetch(&b->refs,1,__ATOMIC_ACQ_REL)==0){
+        free(b);
+    }
+}
+
+void editor_UpdateRows(erow *row){
+    TRACE_BEGIN(trace);
+    E.perf.rows_rendered++;
+    long long counted=E.wrap.on?editor_wrap_count(row-E.row):0; // what the visual line index has for it
+    int tabs=0;
+    int j;
+    for(j=0;j<row->size;j++){
+        if(row->chars[j]=='\t'){
+            tabs++;
+        }
+    }
+    editor_chars_free(row->render); // a new one,a pasted row may share the old one
+    row->render=editor_chars_alloc(row->size+tabs*(DELULU_TAB_STOP-1));
+    int idx=0;
+    for(j=0;j<row->size;j++){
+        if(row->chars[j]=='\t'){
+            row->render[idx++]=' ';
+            while(idx % DELULU_TAB_STOP !=0){
+                row->render[idx++]=' ';
+            }
+        }else{
+            row->render[idx++]=row->chars[j];
+        }
+    }
+    row->render[idx]='\0';
+    row->rsize=idx;
+    row->wrapw=0;
+    if(E.wrap.on){
+        editor_wrap_layout(row-E.row,counted); // an edited row is laid out again right away
+    }
+    TRACE_END(trace,"update_row");
+}
+
+// Make row->chars private to this row with room for len bytes plus the terminator,
+// the caller is about to change it so it no longer matches the file on disk
+void editor_row_reserve(erow *row,size_t len){
+    struct rowbuf *b=editor_rowbuf(row->chars);
+    if(__atomic_load_n(&b->refs,__ATOMIC_ACQUIRE)>1){
+        // Shared with a snapshot: copy on write
+        char *chars=editor_chars_new(row->chars,row->size);
+        editor_chars_free(row->chars);
+        row->chars=chars;
+        b=editor_rowbuf(chars);
+    }
+    b->disk=-1;
+    if(len+1>b->cap){
+        size_t cap=b->cap*2>len+1?b->cap*2:len+1;
+        b=realloc(b,sizeof(struct rowbuf)+cap);
+        b->cap=cap;
+        row->chars=b->chars;
+    }
+}
+
+void editor_AppendRows(int at,char *s,size_t len){
+    if(at<0||at>E.numrows){
+        return;
+    }
+    TRACE_BEGIN(trace);
+    editor_edit_record(UNDO_INSERT_ROW,at,0,s,len);
+    E.row=realloc(E.row,sizeof(erow)*(E.numrows+1)); // Reallocate memory for the rows array
+    editor_rows_moved(at,1);
+    memmove(&E.row[at+1],&E.row[at],sizeof(erow)*(E.numrows-at)); // Shift rows below down by one to make room
+    //int at = E.numrows; // Get the current number of rows
+    E.row[at].size = len; // Set the size of the new row
+    E.row[at].chars = editor_chars_new(s, len); // Copy the characters into a fresh null-terminated buffer
+    E.row[at].rsize=0;//Contains size of contents of render string
+    E.row[at].render=NULL;
+    E.row[at].wrap=NULL;
+    E.row[at].wrapw=0;
+    editor_UpdateRows(&E.row[at]);
+    E.numrows++; // Increment the number of rows
+    E.dirty++;
+    TRACE_END(trace,"insert_row");
+
+}
+
+// Every row mutation reports itself here: to the undo log and to the crash-recovery swap file
+void editor_edit_record(int type,int row,int col,const char *s,size_t len){
+    if(E.undo.disabled){
+        return; // loading a file is not an edit
+    }
+    editor_swap_record(type,row,col,s,len);
+    editor_undo_record(type,row,col,s,len);
+}
+
+void editorFreerow(erow *row){
+    editor_chars_free(row->render);
+    free(row->wrap);
+    editor_chars_free(row->chars);
+}
+
+void editor_DelRow(int at){
+    if(at<0||at>=E.numrows){
+        return;
+    }
+    TRACE_BEGIN(trace);
+    editor_edit_record(UNDO_DELETE_ROW,at,0,E.row[at].chars,E.row[at].size);
+    editorFreerow(&E.row[at]);
+    memmove(&E.row[at],&E.row[at+1],sizeof(erow)*(E.numrows-at-1)); // Close the gap left by the deleted row
+    editor_rows_moved(at,-1);
+    E.numrows--;
+    E.dirty++;
+    TRACE_END(trace,"delete_row");
+}
+
+// Insert the '\n' separated lines of text as rows at at,growing the row table once.
+// Returns the number of rows inserted.
+int editor_InsertRows(int at,const char *text,size_t len){
+    if(at<0||at>E.numrows){
+        return 0;
+    }
+    TRACE_BEGIN(trace);
+    const char *p=text,*end=text+len;
+    int n=1,j;
+    while((p=memchr(p,'\n',end-p))!=NULL){
+        n++;
+        p++;
+    }
+    editor_edit_record(UNDO_INSERT_ROWS,at,n,text,len);
+    E.row=realloc(E.row,sizeof(erow)*(E.numrows+n));
+    memmove(&E.row[at+n],&E.row[at],sizeof(erow)*(E.numrows-at));
+    editor_rows_moved(at,n);
+    p=text;
+    for(j=0;j<n;j++){
+        const char *e=memchr(p,'\n',end-p);
+        if(e==NULL){
+            e=end;
+        }
+        erow *row=&E.row[at+j];
+        row->size=e-p;
+        row->chars=editor_chars_new(p,e-p);
+        row->rsize=0;
+        row->render=NULL;
+        row->wrap=NULL;
+        row->wrapw=0;
+        editor_UpdateRows(row);
+        p=e+1;
+    }
+    E.numrows+=n;
+    E.dirty++;
+    TRACE_END(trace,"insert_rows");
+    return n;
+}
+
+// Text of n rows joined by '\n',what an undo of their deletion puts back
+char *editor_rows_join(const erow *rows,int n,size_t *len){
+    size_t total=0;
+    int j;
+    for(j=0;j<n;j++){
+        total+=rows[j].size+1;
+    }
+    char *text=malloc(total),*p=text;
+    for(j=0;j<n;j++){
+        memcpy(p,rows[j].chars,rows[j].size);
+        p+=rows[j].size;
+        *p++='\n';
+    }
+    *len=total-1;
+    return text;
+}
+
+// Take n rows from at out of the table,into keep when it is not NULL (their wrap layouts dropped)
+void editor_rows_remove(int at,int n,erow *keep){
+    TRACE_BEGIN(trace);
+    // Only the undo log needs the text; replaying and the swap file go by the row count
+    char *text=NULL;
+    size_t len=0;
+    int j;
+    if(!E.undo.replaying&&!E.undo.disabled){
+        for(j=at;j<at+n;j++){
+            len+=E.row[j].size+1;
+        }
+        if(--len<=DELULU_UNDO_BUDGET/4){
+            text=editor_rows_join(&E.row[at],n,&len); // more than that clears the undo log instead
+        }
+    }
+    editor_edit_record(UNDO_DELETE_ROWS,at,n,text,len);
+    free(text);
+    for(j=at;j<at+n;j++){
+        if(keep){
+            free(E.row[j].wrap);
+            E.row[j].wrap=NULL;
+            E.row[j].wrapw=0;
+            keep[j-at]=E.row[j];
+        }else{
+            editorFreerow(&E.row[j]);
+        }
+    }
+    memmove(&E.row[at],&E.row[at+n],sizeof(erow)*(E.numrows-at-n));
+    editor_rows_moved(at,-n);
+    E.numrows-=n;
+    E.dirty++;
+    TRACE_END(trace,"delete_rows");
+}
+
+void editor_DelRows(int at,int n){
+    if(at<0||at>=E.numrows||n<=0){
+        return;
+    }
+    if(n>E.numrows-at){
+        n=E.numrows-at;
+    }
+    editor_rows_remove(at,n,NULL);
+}
+
+// Insert n rows at at that share their chars and render with rows,nothing is copied or rendered.
+// Their disk offsets come along: a save only leaves a row in place when it sits at its offset,and
+// the kill ring forgets offsets whenever the file changes (editor_kill_disk).
+void editor_rows_put(int at,const erow *rows,int n){
+    if(at<0||at>E.numrows||n<=0){
+        return;
+    }
+    TRACE_BEGIN(trace);
+    char *text=NULL;
+    size_t len=0;
+    if(!E.undo.replaying&&!E.undo.disabled){
+        text=editor_rows_join(rows,n,&len); // the undo log and swap file still want the text
+    }
+    editor_edit_record(UNDO_INSERT_ROWS,at,n,text,len);
+    free(text);
+    E.row=realloc(E.row,sizeof(erow)*(E.numrows+n));
+    memmove(&E.row[at+n],&E.row[at],sizeof(erow)*(E.numrows-at));
+    editor_rows_moved(at,n);
+    int j;
+    for(j=0;j<n;j++){
+        erow *row=&E.row[at+j];
+        *row=rows[j];
+        row->chars=editor_chars_share(rows[j].chars);
+        row->render=editor_chars_share(rows[j].render);
+        row->wrap=NULL;
+        row->wrapw=0;
+    }
+    E.numrows+=n;
+    E.dirty++;
+    TRACE_END(trace,"put_rows");
+}
+
+// The edit without editor_UpdateRows,for changing a row in several places and rendering it once
+void editor_row_insert(erow *row,int at,const char *s,size_t len){
+    if(at<0||at>row->size){
+        at=row->size;
+    }
+    editor_edit_record(UNDO_INSERT_CHARS,row-E.row,at,s,len);
+    editor_row_reserve(row,row->size+len);
+    memmove(&row->chars[at+len],&row->chars[at],row->size-at+1); //comes from string same like mmcpy but safer 
+    memcpy(&row->chars[at],s,len);
+    row->size+=len;
+    editor_index_add(&E.lines,row-E.row,len);
+    E.dirty++;
+}
+
+void editor_RowinsertString(erow *row,int at,const char *s,size_t len){
+    TRACE_BEGIN(trace);
+    editor_row_insert(row,at,s,len);
+    editor_UpdateRows(row);
+    TRACE_END(trace,"row_insert");
+}
+
+void editor_RowinsertChar(erow *row,int at,int c){
+    char ch=c;
+    editor_RowinsertString(row,at,&ch,1);
+}
+
+void editorRowAppendString(erow *row,char *s,size_t len){
+    editor_RowinsertString(row,row->size,s,len);
+}
+
+// Returns 0 when there was nothing to delete
+int editor_row_delete(erow *row,int at,int len){
+    if(at<0||at>=row->size||len<=0){
+        return 0;
+    }
+    if(len>row->size-at){
+        len=row->size-at;
+    }
+    editor_edit_record(UNDO_DELETE_CHARS,row-E.row,at,&row->chars[at],len);
+    editor_row_reserve(row,row->size);
+    memmove(&row->chars[at],&row->chars[at+len],row->size-at-len+1);
+    row->size-=len;
+    editor_index_add(&E.lines,row-E.row,-len);
+    E.dirty++;
+    return 1;
+}
+
+void editor_rowdelrange(erow *row,int at,int len){
+    TRACE_BEGIN(trace);
+    if(editor_row_delete(row,at,len)){
+        editor_UpdateRows(row);
+    }
+    TRACE_END(trace,"row_delete");
+}
+
+void editor_rowdelchar(erow *row,int at){
+    editor_rowdelrange(row,at,1);
+}
+
+/*editor operations*/
+void editor_insertchar(int c){
+    if(E.cy==E.numrows){
+        editor_AppendRows(E.numrows,"",0);
+    }
+    editor_RowinsertChar(&E.row[E.cy],E.cx,c);
+    E.cx++;
+}
+
+void editor_insertNEwline(){
+    if(E.cx==0){
+        editor_AppendRows(E.cy,"",0);
+    }else{
+        erow *row=&E.row[E.cy];
+        editor_AppendRows(E.cy+1,&row->chars[E.cx],row->size-E.cx);
+        row=&E.row[E.cy];
+        editor_rowdelrange(row,E.cx,row->size-E.cx);
+    }
+    E.cy++;
+    E.cx=0;
+}
+
+// Insert text that may hold many lines at the cursor: the first line joins the cursor row,
+// the others go in with one editor_InsertRows and the rest of the cursor row follows the last.
+// Line ends are '\n'.
+void editor_insert_text(const char *s,size_t len){
+    if(len==0){
+        return;
+    }
+    if(E.cy==E.numrows){
+        editor_AppendRows(E.numrows,"",0);
+    }
+    erow *row=&E.row[E.cy];
+    const char *nl=memchr(s,'\n',len);
+    if(nl==NULL){
+        editor_RowinsertString(row,E.cx,s,len);
+        E.cx+=len;
+        return;
+    }
+    size_t tlen=row->size-E.cx;
+    char *tail=NULL;
+    if(tlen){
+        tail=malloc(tlen);
+        memcpy(tail,&row->chars[E.cx],tlen);
+        editor_rowdelrange(row,E.cx,tlen);
+    }
+    if(nl>s){
+        editor_RowinsertString(row,E.cx,s,nl-s);
+    }
+    E.cy+=editor_InsertRows(E.cy+1,nl+1,len-(nl-s)-1);
+    row=&E.row[E.cy];
+    E.cx=row->size;
+    if(tlen){
+        editor_RowinsertString(row,row->size,tail,tlen);
+        free(tail);
+    }
+}
+
+// Insert the last bracketed paste. Terminals send line breaks as \r (some as \r\n or \n),
+// they are folded to \n in place first.
+void editor_paste(){
+    size_t i,j=0;
+    char *s=E.paste.buf;
+    for(i=0;i<E.paste.len;i++){
+        if(s[i]=='\r'){
+            if(i+1<E.paste.len&&s[i+1]=='\n'){
+                continue;
+            }
+            s[j++]='\n';
+        }else{
+            s[j++]=s[i];
+        }
+    }
+    E.paste.len=j;
+    if(E.cursors.n&&memchr(s,'\n',j)==NULL){
+        editor_cursors_edit(s,j,0); // a line's worth goes in at every cursor
+        return;
+    }
+    editor_cursors_clear();
+    editor_insert_text(s,j);
+}
+
+void editor_delchar(){
+    if(E.cy==E.numrows){
+        return;
+    }
+    if(E.cx==0&&E.cy==0){
+        return;
+    }
+    erow *row=&E.row[E.cy];
+    if(E.cx>0){
+        editor_rowdelchar(row,E.cx-1);
+        E.cx--;
+    }else{
+        E.cx=E.row[E.cy-1].size;
+        editorRowAppendString(&E.row[E.cy-1],row->chars,row->size);
+        editor_DelRow(E.cy);
+        E.cy--;
+    }
+}
+
+/*undo*/
+// Every mutation above reports itself through editor_edit_record() as a small delta record.
+// Records live back to back in one contiguous byte log: [header][payload][u32 record size].
+// The trailing size lets us walk the log backwards for undo and forwards for redo.
+// A user action (one keypress) is a group; its first record carries UNDO_GROUP_START.
+// Offsets are absolute positions in the whole history: memory holds the window [base,len),
+// anything older lives only in the on-disk journal (see the journal section below).
+int editor_undo_recsize(const struct undo_rec *r){
+    return sizeof(struct undo_rec)+((r->flags&UNDO_NOPAYLOAD)?0:r->len)+sizeof(unsigned int);
+}
+
+// Pointer to history byte off,from the memory window or the journal mapping
+char *editor_undo_at(size_t off){
+    if(off>=E.undo.base){
+        return &E.undo.log[off-E.undo.base];
+    }
+    if(editor_undo_journal_map(UNDO_JOURNAL_HDR+off+sizeof(struct undo_rec))==-1){
+        return NULL;
+    }
+    return &E.undo.jmap[UNDO_JOURNAL_HDR+off];
+}
+
+// Size of the record that ends at offset off,read from its trailer
+unsigned int editor_undo_prevsize(size_t off){
+    unsigned int sz=0;
+    char *p=editor_undo_at(off-sizeof(sz));
+    if(p){
+        memcpy(&sz,p,sizeof(sz));
+    }
+    return sz;
+}
+
+// Lowest offset undo can walk back to
+size_t editor_undo_floor(){
+    return (E.undo.jfd!=-1)?E.undo.jfirst:E.undo.base;
+}
+
+void editor_undo_clear(){
+    E.save.upos=UNDO_NOT_SAVED;
+    E.undo.base=0;
+    E.undo.len=0;
+    E.undo.pos=0;
+    E.undo.group=0;
+    E.undo.last=-1;
+    E.undo.synced=0;
+    E.undo.jfirst=0;
+}
+
+// Drop whole groups from the front of the window until it fits in the budget again.
+// The group being recorded is never cut in half: if it alone is over budget the history goes.
+// With a journal the dropped records are still on disk,without one they are gone.
+void editor_undo_trim(){
+    editor_undo_flush();
+    size_t cut=E.undo.base;
+    while(E.undo.len-cut>DELULU_UNDO_BUDGET*3/4&&cut<E.undo.group){
+        struct undo_rec r;
+        do{
+            memcpy(&r,editor_undo_at(cut),sizeof(r));
+            cut+=editor_undo_recsize(&r);
+            if(cut<E.undo.len){
+                memcpy(&r,editor_undo_at(cut),sizeof(r));
+            }
+        }while(cut<E.undo.group&&!(r.flags&UNDO_GROUP_START));
+    }
+    if(E.undo.len-cut>DELULU_UNDO_BUDGET){
+        editor_undo_clear();
+        editor_undo_journal_reset();
+        E.undo.skip=1;
+        editor_setstatus_Message("Change too large for undo budget, undo history cleared");
+        return;
+    }
+    if(cut==E.undo.base){
+        return;
+    }
+    memmove(E.undo.log,editor_undo_at(cut),E.undo.len-cut);
+    E.undo.base=cut;
+    if(E.undo.last<(long)cut){
+        E.undo.last=-1;
+    }
+}
+
+// Try to fold a new record into the previous one (runs of typing or backspacing)
+int editor_undo_coalesce(int type,int row,int col,const char *s,size_t len){
+    if(E.undo.last<(long)E.undo.base||!E.undo.coalesce||E.undo.len-E.undo.base+len>E.undo.cap){
+        return 0;
+    }
+    struct undo_rec r;
+    char *p=editor_undo_at(E.undo.last);
+    memcpy(&r,p,sizeof(r));
+    if(r.type!=type||r.row!=row||(r.flags&UNDO_NOPAYLOAD)||r.len+len>DELULU_UNDO_COALESCE_MAX){
+        return 0;
+    }
+    char *payload=p+sizeof(r);
+    if((type==UNDO_INSERT_CHARS&&col==r.col+(int)r.len)||(type==UNDO_DELETE_CHARS&&col==r.col)){
+        memcpy(payload+r.len,s,len); // typing forward or deleting forward: payload grows at the end
+    }else if(type==UNDO_DELETE_CHARS&&col+(int)len==r.col){
+        memmove(payload+len,payload,r.len); // backspacing: the new bytes go in front of the old ones
+        memcpy(payload,s,len);
+        r.col=col;
+    }else{
+        return 0;
+    }
+    r.len+=len;
+    memcpy(p,&r,sizeof(r));
+    unsigned int sz=editor_undo_recsize(&r);
+    memcpy(p+sz-sizeof(sz),&sz,sizeof(sz));
+    E.undo.len=E.undo.pos=E.undo.last+sz;
+    if(E.undo.synced>(size_t)E.undo.last){
+        E.undo.synced=E.undo.last;
+    }
+    return 1;
+}
+
+void editor_undo_record(int type,int row,int col,const char *s,size_t len){
+    if(E.undo.replaying||E.undo.disabled){
+        return;
+    }
+    if(E.undo.pos<E.undo.len){
+        editor_undo_truncate(); // a fresh edit discards the redo tail
+    }
+    if(E.undo.skip){
+        return;
+    }
+    if(!E.undo.start&&editor_undo_coalesce(type,row,col,s,len)){
+        return;
+    }
+    struct undo_rec r;
+    memset(&r,0,sizeof(r));
+    r.type=type;
+    r.row=row;
+    r.col=col;
+    r.len=len;
+    r.cx=E.cx;
+    r.cy=E.cy;
+    r.acx=E.cx;
+    r.acy=E.cy;
+    if(E.undo.start){
+        r.flags|=UNDO_GROUP_START;
+    }
+    if(len>DELULU_UNDO_BUDGET/4){
+        if(type==UNDO_INSERT_CHARS||type==UNDO_INSERT_ROW||type==UNDO_INSERT_ROWS){
+            // Undoing an insert only needs its extent, so huge inserts keep no bytes (and can't be redone)
+            r.flags|=UNDO_NOPAYLOAD;
+        }else{
+            // Can't keep the bytes of a huge delete: this action and everything before it become final
+            editor_undo_clear();
+            editor_undo_journal_reset();
+            E.undo.skip=1;
+            editor_setstatus_Message("Change too large for undo budget, undo history cleared");
+            return;
+        }
+    }
+    size_t need=editor_undo_recsize(&r);
+    size_t used=E.undo.len-E.undo.base;
+    if(used+need>E.undo.cap){
+        size_t cap=E.undo.cap?E.undo.cap:4096;
+        while(cap<used+need){
+            cap*=2;
+        }
+        char *log=realloc(E.undo.log,cap);
+        if(log==NULL){
+            editor_undo_clear();
+            editor_undo_journal_reset();
+            return;
+        }
+        E.undo.log=log;
+        E.undo.cap=cap;
+    }
+    if(E.undo.start){
+        E.undo.group=E.undo.len;
+    }
+    E.undo.last=E.undo.len;
+    memcpy(&E.undo.log[used],&r,sizeof(r));
+    if(!(r.flags&UNDO_NOPAYLOAD)){
+        memcpy(&E.undo.log[used+sizeof(r)],s,len);
+    }
+    unsigned int sz=need;
+    memcpy(&E.undo.log[used+need-sizeof(sz)],&sz,sizeof(sz));
+    E.undo.len+=need;
+    E.undo.pos=E.undo.len;
+    E.undo.start=0;
+    if(E.undo.len-E.undo.base>DELULU_UNDO_BUDGET){
+        editor_undo_trim();
+    }
+}
+
+// Cut history at the undo point,if that point is older than the memory window the window restarts there
+void editor_undo_truncate(){
+    E.undo.len=E.undo.pos;
+    if(E.undo.pos<E.undo.base){
+        E.undo.base=E.undo.pos;
+    }
+    if(E.undo.last>=(long)E.undo.pos){
+        E.undo.last=-1;
+    }
+    if(E.undo.synced>E.undo.pos){
+        E.undo.synced=E.undo.pos;
+    }
+    if((E.undo.jfd!=-1||E.undo.jlazy)&&E.undo.jsaved>E.undo.pos){
+        E.undo.jsaved=UNDO_NOT_SAVED; // the on-disk state is no longer reachable through this history
+    }
+    if(E.save.active&&E.save.upos>E.undo.pos){
+        E.save.upos=UNDO_NOT_SAVED; // same for the state a running save is writing
+    }
+}
+
+// Called once per keypress: seals the previous action (stamping the cursor it left behind)
+// and decides whether the next edit extends it or opens a new group
+void editor_undo_boundary(int kind){
+    if(E.undo.last>=(long)E.undo.base&&(size_t)E.undo.last<E.undo.len){
+        struct undo_rec r;
+        char *p=editor_undo_at(E.undo.last);
+        memcpy(&r,p,sizeof(r));
+        r.acx=E.cx;
+        r.acy=E.cy;
+        memcpy(p,&r,sizeof(r));
+        if(E.undo.synced>(size_t)E.undo.last){
+            E.undo.synced=E.undo.last;
+        }
+    }
+    editor_undo_flush();
+    E.undo.coalesce=(kind!=UNDO_KIND_OTHER&&kind==E.undo.kind);
+    if(!E.undo.coalesce){
+        E.undo.start=1;
+        E.undo.skip=0;
+    }
+    E.undo.kind=kind;
+}
+
+void editor_undo_apply(const struct undo_rec *r,const char *payload,int inverse){
+    int type=r->type;
+    if(inverse){
+        switch(type){
+        case UNDO_INSERT_CHARS: type=UNDO_DELETE_CHARS; break;
+        case UNDO_DELETE_CHARS: type=UNDO_INSERT_CHARS; break;
+        case UNDO_INSERT_ROW: type=UNDO_DELETE_ROW; break;
+        case UNDO_DELETE_ROW: type=UNDO_INSERT_ROW; break;
+        case UNDO_INSERT_ROWS: type=UNDO_DELETE_ROWS; break;
+        case UNDO_DELETE_ROWS: type=UNDO_INSERT_ROWS; break;
+        }
+    }
+    switch(type){
+    case UNDO_INSERT_CHARS:
+        if(r->row<E.numrows){
+            editor_RowinsertString(&E.row[r->row],r->col,payload,r->len);
+        }
+        break;
+    case UNDO_DELETE_CHARS:
+        if(r->row<E.numrows){
+            editor_rowdelrange(&E.row[r->row],r->col,r->len);
+        }
+        break;
+    case UNDO_INSERT_ROW:
+        editor_AppendRows(r->row,(char *)payload,r->len);
+        break;
+    case UNDO_DELETE_ROW:
+        editor_DelRow(r->row);
+        break;
+    case UNDO_INSERT_ROWS:
+        editor_InsertRows(r->row,payload,r->len);
+        break;
+    case UNDO_DELETE_ROWS:
+        editor_DelRows(r->row,r->col);
+        break;
+    }
+}
+
+void editor_undo_clampcursor(){
+    if(E.cy>E.numrows){
+        E.cy=E.numrows;
+    }
+    if(E.cy<0){
+        E.cy=0;
+    }
+    int rowlen=(E.cy<E.numrows)?E.row[E.cy].size:0;
+    if(E.cx>rowlen){
+        E.cx=rowlen;
+    }
+}
+
+void editor_undo(){
+    if(E.undo.pos<=editor_undo_floor()){
+        editor_setstatus_Message("Nothing to undo");
+        return;
+    }
+    E.undo.replaying=1;
+    struct undo_rec r;
+    do{
+        size_t off=E.undo.pos-editor_undo_prevsize(E.undo.pos);
+        char *p=editor_undo_at(off);
+        if(p==NULL||off>=E.undo.pos){
+            editor_setstatus_Message("Undo journal is damaged");
+            break;
+        }
+        memcpy(&r,p,sizeof(r));
+        editor_undo_apply(&r,p+sizeof(r),1);
+        E.undo.pos=off;
+    }while(!(r.flags&UNDO_GROUP_START)&&E.undo.pos>editor_undo_floor());
+    E.undo.replaying=0;
+    E.undo.last=-1;
+    E.cx=r.cx;
+    E.cy=r.cy;
+    editor_undo_clampcursor();
+    E.undo.kind=UNDO_KIND_OTHER;
+}
+
+void editor_redo(){
+    if(E.undo.pos==E.undo.len){
+        editor_setstatus_Message("Nothing to redo");
+        return;
+    }
+    // A group holding a payload-less insert can only be undone
+    size_t off=E.undo.pos;
+    struct undo_rec r;
+    do{
+        char *p=editor_undo_at(off);
+        if(p==NULL){
+            editor_setstatus_Message("Undo journal is damaged");
+            return;
+        }
+        memcpy(&r,p,sizeof(r));
+        if(r.flags&UNDO_NOPAYLOAD){
+            editor_setstatus_Message("Can't redo: change exceeded the undo budget");
+            return;
+        }
+        off+=editor_undo_recsize(&r);
+        if(off<E.undo.len){
+            memcpy(&r,editor_undo_at(off),sizeof(r));
+        }
+    }while(off<E.undo.len&&!(r.flags&UNDO_GROUP_START));
+    E.undo.replaying=1;
+    do{
+        char *p=editor_undo_at(E.undo.pos);
+        memcpy(&r,p,sizeof(r));
+        editor_undo_apply(&r,p+sizeof(r),0);
+        E.undo.pos+=editor_undo_recsize(&r);
+        if(E.undo.pos<E.undo.len){
+            struct undo_rec next;
+            memcpy(&next,editor_undo_at(E.undo.pos),sizeof(next));
+            if(next.flags&UNDO_GROUP_START){
+                break;
+            }
+        }
+    }while(E.undo.pos<E.undo.len);
+    E.undo.replaying=0;
+    E.undo.last=-1;
+    E.cx=r.acx;
+    E.cy=r.acy;
+    editor_undo_clampcursor();
+    E.undo.kind=UNDO_KIND_OTHER;
+}
+
+/*undo journal*/
+// The history is mirrored into an append-only journal next to the file (.name.delulu-undo).
+// Like the swap file it is only created by the first edit,and quitting with nothing unsaved
+// removes it: it outlives a session only to carry edits that never reached the file.
+// Its header names the content hash of the file and the history offset that matches what is
+// on disk,so reopening the same contents picks the history up again: older records are undo,
+// newer ones (edits that were never saved) are redo. editor_open only reads the header,the
+// records are mapped on first use and paged in only when undo actually walks back into them.
+unsigned long long editor_hash(unsigned long long h,const char *s,size_t len){
+    // FNV-1a,start with DELULU_HASH_INIT
+    size_t j;
+    for(j=0;j<len;j++){
+        h^=(unsigned char)s[j];
+        h*=1099511628211ULL;
+    }
+    return h;
+}
+
+// Hidden file next to filename: dir/.name<suffix>
+char *editor_sidecar_path(const char *filename,const char *suffix){
+    const char *slash=strrchr(filename,'/');
+    int dirlen=slash?slash-filename+1:0;
+    char *path=malloc(strlen(filename)+strlen(suffix)+2);
+    sprintf(path,"%.*s.%s%s",dirlen,filename,filename+dirlen,suffix);
+    return path;
+}
+
+// Make sure at least need bytes of the journal are mapped,growing the file when writing past its end
+int editor_undo_journal_map(size_t need){
+    if(E.undo.jfd==-1){
+        return -1;
+    }
+    if(E.undo.jmap&&need<=E.undo.jmaplen){
+        return 0;
+    }
+    struct stat st;
+    if(fstat(E.undo.jfd,&st)==-1){
+        return -1;
+    }
+    size_t len=st.st_size;
+    if(need>len){
+        len=(need+UNDO_JOURNAL_CHUNK-1)/UNDO_JOURNAL_CHUNK*UNDO_JOURNAL_CHUNK;
+        if(ftruncate(E.undo.jfd,len)==-1){
+            return -1;
+        }
+    }
+    char *map=mmap(NULL,len,PROT_READ|PROT_WRITE,MAP_SHARED,E.undo.jfd,0);
+    if(map==MAP_FAILED){
+        return -1;
+    }
+    if(E.undo.jmap){
+        munmap(E.undo.jmap,E.undo.jmaplen);
+    }
+    E.undo.jmap=map;
+    E.undo.jmaplen=len;
+    return 0;
+}
+
+void editor_undo_journal_close(){
+    if(E.undo.jmap){
+        munmap(E.undo.jmap,E.undo.jmaplen);
+    }
+    if(E.undo.jfd!=-1){
+        close(E.undo.jfd);
+    }
+    E.undo.jmap=NULL;
+    E.undo.jmaplen=0;
+    E.undo.jfd=-1;
+    E.undo.jlazy=0;
+}
+
+// Close the journal and delete its file,used when quitting leaves nothing worth resuming
+void editor_undo_journal_remove(const char *filename){
+    int had=E.undo.jfd!=-1;
+    editor_undo_journal_close();
+    if(had&&filename){
+        char *path=editor_sidecar_path(filename,".delulu-undo");
+        unlink(path);
+        free(path);
+    }
+}
+
+void editor_undo_journal_writehdr(){
+    struct undo_journal_hdr h;
+    memset(&h,0,sizeof(h));
+    memcpy(h.magic,UNDO_JOURNAL_MAGIC,sizeof(h.magic));
+    h.key=E.undo.jkey;
+    h.saved=E.undo.jsaved;
+    h.first=E.undo.jfirst;
+    h.end=E.undo.synced;
+    if(E.undo.jmap){
+        memcpy(E.undo.jmap,&h,sizeof(h));
+    }else if(pwrite(E.undo.jfd,&h,sizeof(h),0)!=sizeof(h)){
+        editor_undo_journal_close();
+    }
+}
+
+// Start an empty journal keyed by the current contents,the in-memory window becomes its first records
+void editor_undo_journal_reset(){
+    if(E.undo.jfd==-1){
+        return;
+    }
+    if(E.undo.jmap){
+        munmap(E.undo.jmap,E.undo.jmaplen);
+        E.undo.jmap=NULL;
+        E.undo.jmaplen=0;
+    }
+    E.undo.jfirst=E.undo.base;
+    E.undo.synced=E.undo.base;
+    if(E.undo.jsaved<E.undo.base||E.undo.jsaved>E.undo.len){
+        E.undo.jsaved=UNDO_NOT_SAVED;
+    }
+    if(ftruncate(E.undo.jfd,UNDO_JOURNAL_HDR)==-1){
+        editor_undo_journal_close();
+        return;
+    }
+    editor_undo_journal_writehdr();
+}
+
+// Attach the journal for filename whose contents hash to key,resuming its history when the key matches.
+// Without a usable journal file none is made yet: editor_undo_flush creates it for the first edit.
+void editor_undo_journal_open(const char *filename,unsigned long long key){
+    editor_undo_journal_close();
+    char *path=editor_sidecar_path(filename,".delulu-undo");
+    E.undo.jfd=open(path,O_RDWR|O_NOFOLLOW|O_CLOEXEC); // not through a planted symlink
+    struct undo_journal_hdr h;
+    struct stat st;
+    E.undo.jkey=key;
+    E.undo.jsaved=E.undo.pos;
+    if(E.undo.jfd!=-1&&pread(E.undo.jfd,&h,sizeof(h),0)==sizeof(h)&&memcmp(h.magic,UNDO_JOURNAL_MAGIC,sizeof(h.magic))==0&&
+       h.key==key&&h.saved!=UNDO_NOT_SAVED&&h.first<=h.saved&&h.saved<=h.end&&h.first<h.end&&fstat(E.undo.jfd,&st)==0&&
+       UNDO_JOURNAL_HDR+h.end<=(unsigned long long)st.st_size&&E.undo.len==0){
+        // Same contents as when the history was left: everything stays on disk until it is needed
+        E.undo.jfirst=h.first;
+        E.undo.base=E.undo.len=E.undo.synced=h.end;
+        E.undo.pos=E.undo.jsaved=h.saved;
+        E.undo.group=E.undo.len;
+        free(path);
+        return;
+    }
+    if(E.undo.jfd!=-1){
+        close(E.undo.jfd); // history of other contents,or none at all
+        E.undo.jfd=-1;
+        unlink(path);
+    }
+    free(path);
+    E.undo.jlazy=1;
+}
+
+// The first edit since the file was opened: make the journal,it starts from the window
+int editor_undo_journal_create(){
+    char *path=editor_sidecar_path(E.filename,".delulu-undo");
+    E.undo.jlazy=0;
+    E.undo.jfd=open(path,O_RDWR|O_CREAT|O_TRUNC|O_NOFOLLOW|O_CLOEXEC,0600);
+    free(path);
+    if(E.undo.jfd==-1){
+        return -1; // no journal,history stays in memory only
+    }
+    editor_undo_journal_reset();
+    return E.undo.jfd==-1?-1:0;
+}
+
+// Copy the part of the window the journal hasn't seen yet
+void editor_undo_flush(){
+    if(E.undo.synced==E.undo.len){
+        return;
+    }
+    if(E.undo.jfd==-1&&(!E.undo.jlazy||E.filename==NULL||editor_undo_journal_create()==-1)){
+        return;
+    }
+    if(E.undo.synced<E.undo.base){
+        editor_undo_journal_reset();
+    }
+    if(editor_undo_journal_map(UNDO_JOURNAL_HDR+E.undo.len)==-1){
+        editor_undo_journal_close();
+        editor_setstatus_Message("Undo journal disabled: %s",strerror(errno));
+        return;
+    }
+    memcpy(&E.undo.jmap[UNDO_JOURNAL_HDR+E.undo.synced],&E.undo.log[E.undo.synced-E.undo.base],E.undo.len-E.undo.synced);
+    E.undo.synced=E.undo.len;
+    editor_undo_journal_writehdr();
+}
+
+// The file on disk now holds contents hashing to key,reached at history offset pos
+void editor_undo_journal_saved(const char *filename,unsigned long long key,size_t pos){
+    if(E.undo.jfd==-1&&!E.undo.jlazy){
+        editor_undo_journal_open(filename,key);
+    }
+    E.undo.jkey=key;
+    E.undo.jsaved=pos;
+    editor_undo_flush();
+    if(E.undo.jfd==-1){
+        return; // not made yet,it is keyed by these contents when it is
+    }
+    editor_undo_journal_writehdr();
+}
+
+/*swap*/
+// Crash recovery: every mutation is also appended to .name.delulu-swp as the same delta records
+// the undo log uses. Records are batched in memory (a memcpy per keystroke) and written plus
+// fdatasync'd every DELULU_SWAP_INTERVAL ms,so an editor killed with its terminal loses at most
+// that much. A save restarts the swap from the new contents,a clean exit removes it and
+// editor_open replays whatever an earlier session left behind.
+long long editor_now_ms(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (long long)ts.tv_sec*1000+ts.tv_nsec/1000000;
+}
+
+// A write failed: whatever follows would be replayed onto a state missing the lost records,
+// so the swap is emptied (a recovery ignores it) and not written again this session
+void editor_swap_fail(){
+    if(E.swap.fd!=-1){
+        editor_setstatus_Message("Swap file disabled: %s",strerror(errno));
+        if(ftruncate(E.swap.fd,0)==-1){
+            // the header stays,its key no longer matches once the file is saved
+        }
+        close(E.swap.fd);
+        E.swap.fd=-1;
+    }
+    E.swap.len=0;
+    E.swap.unsynced=0;
+    E.swap.failed=1;
+}
+
+void editor_swap_writehdr(){
+    struct swap_hdr h;
+    memset(&h,0,sizeof(h));
+    memcpy(h.magic,SWAP_MAGIC,sizeof(h.magic));
+    h.key=E.swap.key;
+    if(pwrite(E.swap.fd,&h,sizeof(h),0)!=sizeof(h)||ftruncate(E.swap.fd,sizeof(h))==-1){
+        editor_swap_fail();
+        return;
+    }
+    E.swap.off=sizeof(h);
+}
+
+// Write out the batch,with sync also force it to disk
+void editor_swap_flush(int sync){
+    if(E.swap.fd==-1){
+        return;
+    }
+    if(E.swap.len){
+        if(pwrite(E.swap.fd,E.swap.buf,E.swap.len,E.swap.off)!=(ssize_t)E.swap.len){
+            editor_swap_fail();
+            return;
+        }
+        E.swap.off+=E.swap.len;
+        E.swap.len=0;
+        E.swap.unsynced=1;
+    }
+    if(sync&&E.swap.unsynced){
+        fdatasync(E.swap.fd);
+        E.swap.unsynced=0;
+    }
+    E.swap.last_sync=editor_now_ms();
+}
+
+void editor_swap_record(int type,int row,int col,const char *s,size_t len){
+    if(E.swap.replaying||E.swap.failed||E.filename==NULL){
+        return;
+    }
+    if(E.swap.fd==-1){
+        // Created on the first edit,just looking at a file leaves nothing behind
+        char *path=editor_sidecar_path(E.filename,".delulu-swp");
+        E.swap.fd=open(path,O_RDWR|O_CREAT|O_TRUNC|O_NOFOLLOW|O_CLOEXEC,0600); // not through a planted symlink
+        free(path);
+        if(E.swap.fd==-1){
+            return;
+        }
+        editor_swap_writehdr();
+        if(E.swap.fd==-1){
+            return;
+        }
+        E.swap.last_sync=editor_now_ms();
+    }
+    struct undo_rec r;
+    memset(&r,0,sizeof(r));
+    r.type=type;
+    r.row=row;
+    r.col=col;
+    r.len=len;
+    if(s==NULL){
+        r.flags|=UNDO_NOPAYLOAD; // a row deletion replays from its count alone
+        len=0;
+    }
+    unsigned int sz=editor_undo_recsize(&r);
+    if(sz>DELULU_SWAP_BATCH){
+        // Too big to batch: write it straight from the caller's bytes
+        editor_swap_flush(0);
+        struct iovec iov[3]={{&r,sizeof(r)},{(void *)s,len},{&sz,sizeof(sz)}};
+        if(E.swap.fd==-1){
+            return;
+        }
+        if(pwritev(E.swap.fd,iov,3,E.swap.off)!=(ssize_t)sz){
+            editor_swap_fail();
+            return;
+        }
+        E.swap.off+=sz;
+        E.swap.unsynced=1;
+        return;
+    }
+    if(E.swap.len+sz>E.swap.cap){
+        if(E.swap.cap==0){
+            E.swap.buf=malloc(DELULU_SWAP_BATCH);
+            E.swap.cap=DELULU_SWAP_BATCH;
+        }
+        editor_swap_flush(0);
+        if(E.swap.fd==-1){
+            return;
+        }
+    }
+    memcpy(&E.swap.buf[E.swap.len],&r,sizeof(r));
+    if(len){
+        memcpy(&E.swap.buf[E.swap.len+sizeof(r)],s,len);
+    }
+    memcpy(&E.swap.buf[E.swap.len+sizeof(r)+len],&sz,sizeof(sz));
+    E.swap.len+=sz;
+}
+
+// Called from the input loop,makes the batch durable once the interval has passed
+void editor_swap_tick(){
+    if(E.swap.fd==-1||(E.swap.len==0&&!E.swap.unsynced)){
+        return;
+    }
+    if(editor_now_ms()-E.swap.last_sync>=DELULU_SWAP_INTERVAL){
+        editor_swap_flush(1);
+    }
+}
+
+// The file on disk now holds contents hashing to key plus every record before swap offset off:
+// restart the swap from there,keeping only the edits made after that point. Off -1 means
+// the swap did not exist yet at that point,every record in it is newer.
+void editor_swap_saved(unsigned long long key,off_t off){
+    E.swap.key=key;
+    if(E.swap.fd==-1){
+        return;
+    }
+    if(off==-1){
+        off=sizeof(struct swap_hdr);
+    }
+    editor_swap_flush(0);
+    size_t tail=(E.swap.fd!=-1&&E.swap.off>off)?E.swap.off-off:0;
+    char *buf=tail?malloc(tail):NULL;
+    if(tail&&(buf==NULL||pread(E.swap.fd,buf,tail,off)!=(ssize_t)tail)){
+        tail=0;
+    }
+    if(E.swap.fd!=-1){
+        editor_swap_writehdr();
+    }
+    if(E.swap.fd!=-1&&tail){
+        if(pwrite(E.swap.fd,buf,tail,E.swap.off)==(ssize_t)tail){
+            E.swap.off+=tail;
+        }else{
+            editor_swap_fail(); // the edits made during the save are not in it
+        }
+    }
+    free(buf);
+    editor_swap_flush(1);
+}
+
+void editor_swap_remove(){
+    if(E.swap.fd==-1||E.filename==NULL){
+        return;
+    }
+    close(E.swap.fd);
+    E.swap.fd=-1;
+    char *path=editor_sidecar_path(E.filename,".delulu-swp");
+    unlink(path);
+    free(path);
+}
+
+// Hangup or kill: get the batch onto disk and give the terminal back before going down.
+// Only async-signal-safe calls: atexit handlers don't run after _exit.
+void editor_swap_signal(int sig){
+    (void)sig;
+    if(E.swap.fd!=-1&&E.swap.len){
+        if(pwrite(E.swap.fd,E.swap.buf,E.swap.len,E.swap.off)>0){
+            fdatasync(E.swap.fd);
+        }
+    }
+    if(write(STDOUT_FILENO,"\x1b[?2004l\x1b[?1004l",16)==-1){
+        // the terminal is gone
+    }
+    tcsetattr(STDIN_FILENO,TCSAFLUSH,&E.original_termios);
+    _exit(1);
+}
+
+// Replay a swap file left by a session that died with unsaved edits to the contents hashing to key
+void editor_swap_recover(const char *filename,unsigned long long key){
+    E.swap.key=key;
+    char *path=editor_sidecar_path(filename,".delulu-swp");
+    int fd=open(path,O_RDWR|O_NOFOLLOW|O_CLOEXEC);
+    free(path);
+    if(fd==-1){
+        return;
+    }
+    struct swap_hdr h;
+    struct stat st;
+    if(fstat(fd,&st)==-1||st.st_size<=(off_t)sizeof(h)||pread(fd,&h,sizeof(h),0)!=sizeof(h)||
+       memcmp(h.magic,SWAP_MAGIC,sizeof(h.magic))!=0){
+        close(fd);
+        return;
+    }
+    if(h.key!=key){
+        close(fd);
+        editor_setstatus_Message("Swap file ignored: %s changed since it was written",filename);
+        return;
+    }
+    char *map=mmap(NULL,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    if(map==MAP_FAILED){
+        close(fd);
+        return;
+    }
+    size_t off=sizeof(h);
+    int count=0;
+    E.swap.replaying=1;
+    E.undo.start=1; // the whole recovery is one undoable action
+    while(off+sizeof(struct undo_rec)+sizeof(unsigned int)<=(size_t)st.st_size){
+        struct undo_rec r;
+        unsigned int sz;
+        memcpy(&r,&map[off],sizeof(r));
+        size_t plen=(r.flags&UNDO_NOPAYLOAD)?0:r.len;
+        if(plen>(size_t)st.st_size-off-sizeof(r)-sizeof(sz)){
+            break; // cut short by the crash
+        }
+        memcpy(&sz,&map[off+sizeof(r)+plen],sizeof(sz));
+        if(sz!=(unsigned int)editor_undo_recsize(&r)||r.type<UNDO_INSERT_CHARS||r.type>UNDO_DELETE_ROWS){
+            break;
+        }
+        editor_undo_apply(&r,&map[off+sizeof(r)],0);
+        off+=sz;
+        count++;
+    }
+    E.swap.replaying=0;
+    munmap(map,st.st_size);
+    // Keep appending after the last good record
+    E.swap.fd=fd;
+    E.swap.off=off;
+    E.swap.last_sync=editor_now_ms();
+    if(ftruncate(fd,off)==-1){
+        editor_swap_fail(); // appending after a bad tail would not replay
+    }
+    if(count){
+        editor_setstatus_Message("Recovered %d unsaved edits from swap file (Ctrl+Z to undo)",count);
+    }
+}
+
+/*File i/o */
+void *editor_rowtostring(int *buflen){
+    int totlen=0;
+    int j;
+    for(j=0;j<E.numrows;j++){
+        totlen+=E.row[j].size+1;
+    }
+    *buflen=totlen;
+    char *buf=malloc(totlen);
+    char *p=buf;
+    for(j=0;j<E.numrows;j++){
+        memcpy(p,E.row[j].chars,E.row[j].size);
+        p += E.row[j].size;
+        *p ='\n';
+        p++;
+    }
+    return buf;
+}
+
+// Drop the CRs in front of newlines,what editor_open does to CRLF lines. Returns the new length.
+size_t editor_strip_cr(char *s,size_t len){
+    char *w=s,*r;
+    for(r=s;r<s+len;r++){
+        if(*r!='\r'||r+1==s+len||r[1]!='\n'){
+            *w++=*r;
+        }
+    }
+    return w-s;
+}
+
+// Remember which path E.disk and the row disk offsets belong to
+void editor_disk_path(const char *path){
+    if(E.disk_path==NULL||strcmp(E.disk_path,path)!=0){
+        free(E.disk_path);
+        E.disk_path=strdup(path);
+    }
+}
+
+void editor_open(char *filename)
+{ // Will open and read file from disk
+    editor_kill_disk();
+    free(E.filename);
+    E.filename=strdup(filename);
+    FILE *fp = fopen(filename, "r");
+    if (!fp)
+    {
+        die("fopen");
+    }
+    // char *line="Hello to Delulu";
+    // ssize_t linelen=15;
+    char *line = NULL;
+    ssize_t linecap = 0;
+    ssize_t linelen;
+    unsigned long long key=DELULU_HASH_INIT; // Content hash that keys the undo journal
+    E.undo.disabled++; // Loading rows is not an edit
+    // linelen = getline(&line, &linecap, fp);
+    // if (linelen != -1)
+    // {
+    //     while (linelen > 0 && (line[linelen - 1] == '\n') || (line[linelen - 1] == '\r'))
+    //     {
+    //         linelen--;
+    //     }
+    //     editor_AppendRows(line,linelen); // Append the line to the editor rows
+    // }
+    long long off=0; // File offset of the line being read
+    int ended=1;     // The last line had its newline
+    long long *offs=NULL; // Line start offsets for the index cache
+    size_t noffs=0,offcap=0;
+    int caching=editor_cache_enabled();
+    int cached=editor_cache_load(filename,fp,&key); // the rows may already be known from the last open
+    if(!cached){
+        editor_blocks_free(&E.blocks);
+    }
+    while(!cached&&(linelen=getline(&line,&linecap,fp))!=-1){
+        ssize_t rawlen=linelen;
+        if(caching){
+            if(noffs==offcap){
+                offcap=offcap?offcap*2:1024;
+                offs=realloc(offs,sizeof(*offs)*offcap);
+            }
+            offs[noffs++]=off;
+        }
+        key=editor_hash(key,line,linelen);
+        editor_blocks_add(&E.blocks,line,linelen,0);
+        while(linelen>0 && (line[linelen-1]=='\n' || line[linelen-1]=='\r')){
+            linelen--; // Remove trailing newline or carriage return
+        }
+        editor_AppendRows(E.numrows,line,linelen); // Append the line to the editor rows
+        if(rawlen==linelen+1&&line[linelen]=='\n'){
+            editor_rowbuf(E.row[E.numrows-1].chars)->disk=off; // saving writes back exactly these bytes
+        }
+        off+=rawlen;
+        ended=line[rawlen-1]=='\n';
+    }
+    if(!cached){
+        E.follow.off=off; // where follow mode picks up
+        E.follow.partial=!ended;
+    }
+    E.disk_ok=fstat(fileno(fp),&E.disk)==0;
+    editor_disk_path(filename);
+    if(caching&&!cached&&E.disk_ok&&off==E.disk.st_size&&off>=DELULU_CACHE_MIN){
+        offs=realloc(offs,sizeof(*offs)*(noffs+1));
+        offs[noffs]=off;
+        editor_cache_write(filename,offs,E.numrows,!ended,key);
+    }
+    free(offs);
+    E.disk_changed=0;
+    E.disk_check_at=editor_now_ms();
+    free(line);
+    fclose(fp);
+    E.undo.disabled--;
+    editor_undo_clear();
+    editor_undo_journal_open(filename,key);
+    E.dirty=0;
+    editor_swap_recover(filename,key);
+}
+
+/*follow*/
+// delulu -F file keeps appending what gets written to the end of the file,like tail -f. inotify
+// on the file and its directory wakes the event loop,only the bytes past E.follow.off are read
+// and they go in with editor_InsertRows,a chunk at a time so frames keep coming during a flood.
+// A file that shrinks or is replaced (log rotation) is loaded again from the start.
+void editor_follow_start(char *filename){
+    struct editor_follow *f=&E.follow;
+    struct stat st;
+    char dir[4096];
+    char *slash=strrchr(filename,'/');
+    f->file=open(filename,O_RDONLY|O_CLOEXEC);
+    f->fd=inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+    f->buf=malloc(DELULU_FOLLOW_CHUNK);
+    if(f->file==-1||fstat(f->file,&st)==-1||f->fd==-1||f->buf==NULL){
+        die("follow");
+    }
+    f->dev=st.st_dev;
+    f->ino=st.st_ino;
+    // The directory tells us when a rotated file is created again under the same name
+    snprintf(dir,sizeof(dir),"%.*s",slash?(int)(slash-filename)+1:1,slash?filename:".");
+    if(inotify_add_watch(f->fd,filename,IN_MODIFY|IN_ATTRIB|IN_MOVE_SELF|IN_DELETE_SELF)==-1||
+       inotify_add_watch(f->fd,dir,IN_CREATE|IN_MOVED_TO)==-1){
+        die("inotify_add_watch");
+    }
+    f->active=1;
+    f->more=1; // it may have grown since it was read
+}
+
+// The file at E.filename was replaced or truncated: load it again
+int editor_follow_reload(){
+    struct editor_follow *f=&E.follow;
+    int fd=open(E.filename,O_RDONLY|O_CLOEXEC);
+    struct stat st;
+    if(fd==-1){
+        return 0; // rotated away and not created again yet
+    }
+    if(E.dirty){
+        close(fd);
+        f->active=0;
+        editor_setstatus_Message("File was replaced on disk,stopped following to keep your changes");
+        return 1;
+    }
+    close(f->file);
+    f->file=fd;
+    if(fstat(fd,&st)==0&&(st.st_ino!=f->ino||st.st_dev!=f->dev)){
+        f->dev=st.st_dev;
+        f->ino=st.st_ino;
+        inotify_add_watch(f->fd,E.filename,IN_MODIFY|IN_ATTRIB|IN_MOVE_SELF|IN_DELETE_SELF); // the new file
+    }
+    while(E.numrows>0){
+        editorFreerow(&E.row[--E.numrows]);
+    }
+    editor_fold_clear();
+    editor_cursors_clear();
+    E.cy=E.cx=E.rowoff=E.coloff=0;
+    char *filename=strdup(E.filename);
+    editor_open(filename); // sets E.follow.off and partial for the new contents
+    free(filename);
+    f->more=1;
+    editor_setstatus_Message("File was truncated or replaced,reloaded");
+    return 1;
+}
+
+// Append the next chunk of new bytes as rows. Returns 1 when the rows changed.
+int editor_follow_read(off_t size){
+    struct editor_follow *f=&E.follow;
+    size_t want=size-f->off<DELULU_FOLLOW_CHUNK?size-f->off:DELULU_FOLLOW_CHUNK;
+    ssize_t n=pread(f->file,f->buf,want,f->off);
+    if(n<=0){
+        return 0;
+    }
+    if(n>1&&f->buf[n-1]=='\r'&&f->off+n<size){
+        n--; // leave a CR for the next chunk,it may be half of a CRLF
+    }
+    char *buf=f->buf,*end=buf+n,*p=buf;
+    int pinned=E.cy>=E.numrows-1; // the cursor is on the last line: keep showing the end
+    int dirty=E.dirty,first=E.numrows;
+    E.undo.disabled++; // what another program wrote is not an edit
+    if(f->partial&&E.numrows>0){
+        // The last row was written without its newline,this is the rest of it
+        char *nl=memchr(buf,'\n',n);
+        size_t len=(nl?nl:end)-buf;
+        erow *row=&E.row[E.numrows-1];
+        editor_RowinsertString(row,row->size,buf,len&&buf[len-1]=='\r'&&nl?len-1:len);
+        p=nl?nl+1:end;
+        f->partial=nl==NULL;
+    }
+    if(p<end){
+        off_t off=f->off+(p-buf);
+        int cr=memchr(p,'\r',end-p)!=NULL;
+        if(cr){
+            end=p+editor_strip_cr(p,end-p);
+        }
+        f->partial=end[-1]!='\n';
+        editor_InsertRows(E.numrows,p,end-p-!f->partial); // a final newline would make an empty row
+        if(!cr){
+            // Rows whose bytes sit unchanged in the file can be left where they are by editor_save
+            int j;
+            for(j=first;j<E.numrows-f->partial;j++){
+                editor_rowbuf(E.row[j].chars)->disk=off;
+                off+=E.row[j].size+1;
+            }
+        }
+    }
+    E.undo.disabled--;
+    E.dirty=dirty;
+    f->off+=n;
+    if(pinned&&E.numrows>0){
+        E.cy=E.numrows-1;
+        E.cx=0;
+    }
+    return 1;
+}
+
+// inotify woke the event loop: the events only say that something happened,editor_follow_tick looks
+void editor_follow_drain(){
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    while(read(E.follow.fd,buf,sizeof(buf))>0){
+    }
+    E.follow.more=1;
+}
+
+// The editor wrote the file itself: its bytes are the rows,not data to append. A save that
+// replaced the file gets the new one opened and watched,or the next tick would see a rotation.
+void editor_follow_saved(const struct stat *st){
+    struct editor_follow *f=&E.follow;
+    if(!f->active){
+        return;
+    }
+    if(st->st_ino!=f->ino||st->st_dev!=f->dev){
+        int fd=open(E.filename,O_RDONLY|O_CLOEXEC);
+        if(fd!=-1){
+            close(f->file);
+            f->file=fd;
+        }
+        f->dev=st->st_dev;
+        f->ino=st->st_ino;
+        inotify_add_watch(f->fd,E.filename,IN_MODIFY|IN_ATTRIB|IN_MOVE_SELF|IN_DELETE_SELF);
+    }
+    f->off=st->st_size;
+    f->partial=0; // every saved row ends with a newline
+    editor_follow_drain(); // the events of the save itself,a tick still looks for anything newer
+}
+
+// Polled from the input loop: returns 1 when there are new rows to show
+int editor_follow_tick(){
+    struct editor_follow *f=&E.follow;
+    struct stat st,path;
+    if(!f->active||!f->more){
+        return 0;
+    }
+    if(E.save.active){
+        return 0; // the file is being written by the editor itself,editor_follow_saved takes it from there
+    }
+    f->more=0;
+    if(fstat(f->file,&st)==-1){
+        return 0;
+    }
+    if(st.st_size<f->off){
+        return editor_follow_reload(); // truncated
+    }
+    if(st.st_size>f->off){
+        int changed=editor_follow_read(st.st_size);
+        f->more=f->off<st.st_size; // the rest after the next frame
+        if(!f->more&&E.disk_ok&&E.disk.st_ino==st.st_ino){
+            E.disk=st; // the rows match the file again,editor_save can keep patching it in place
+        }
+        return changed;
+    }
+    if(stat(E.filename,&path)==0&&(path.st_ino!=f->ino||path.st_dev!=f->dev)){
+        return editor_follow_reload(); // rotated: the old file is drained,go on with the new one
+    }
+    return 0;
+}
+
+/*disk changes*/
+// Another program may rewrite the file while it is open. The file is described by its stat and by
+// blocks of lines,each with a hash of its bytes. A block ends after a line whose own hash is 0
+// modulo DELULU_DISK_BLOCK_ROWS,so boundaries follow the content and an insertion only changes
+// the blocks around it. On focus,on a timer and before saving the file is stat'ed; if it changed
+// and there are no unsaved edits,the blocks it shares with what was read at the start and at the
+// end stay as they are and only the rows in between are replaced,as one undoable action.
+void editor_blocks_add(struct editor_blocks *bl,const char *s,size_t len,int nl){
+    struct disk_block *b;
+    if(bl->n==0||bl->closed){
+        if(bl->n==bl->cap){
+            bl->cap=bl->cap?bl->cap*2:64;
+            bl->b=realloc(bl->b,sizeof(*bl->b)*bl->cap);
+        }
+        b=&bl->b[bl->n];
+        b->off=bl->n?b[-1].off+b[-1].len:0;
+        b->len=0;
+        b->rows=0;
+        b->hash=DELULU_HASH_INIT;
+        bl->n++;
+        bl->closed=0;
+    }
+    b=&bl->b[bl->n-1];
+    unsigned long long h=editor_hash(DELULU_HASH_INIT,s,len);
+    if(nl){
+        h=editor_hash(h,"\n",1);
+    }
+    b->hash=(b->hash^h)*1099511628211ULL;
+    b->len+=len+nl;
+    b->rows++;
+    if(h%DELULU_DISK_BLOCK_ROWS==0||b->rows>=DELULU_DISK_BLOCK_ROWS_MAX){
+        bl->closed=1;
+    }
+}
+
+void editor_blocks_free(struct editor_blocks *bl){
+    free(bl->b);
+    memset(bl,0,sizeof(*bl));
+}
+
+int editor_disk_same(struct disk_block *a,struct disk_block *b){
+    return a->hash==b->hash&&a->len==b->len&&a->rows==b->rows;
+}
+
+// Read the file again and replace the rows that changed. Returns 1 when the screen changed.
+int editor_disk_reload(){
+    FILE *fp=fopen(E.filename,"r");
+    if(fp==NULL){
+        return 0;
+    }
+    struct editor_blocks nb={NULL,0,0,0},*ob=&E.blocks;
+    unsigned long long key=DELULU_HASH_INIT;
+    char *line=NULL;
+    size_t linecap=0;
+    ssize_t linelen;
+    long long size=0;
+    while((linelen=getline(&line,&linecap,fp))!=-1){
+        key=editor_hash(key,line,linelen);
+        editor_blocks_add(&nb,line,linelen,0);
+        size+=linelen;
+    }
+    free(line);
+    struct stat st;
+    if(fstat(fileno(fp),&st)==-1){
+        fclose(fp);
+        editor_blocks_free(&nb);
+        return 0;
+    }
+    // Blocks both versions share at the start and at the end
+    int p=0,s=0,j,prows=0,srows=0,total=0;
+    for(j=0;j<ob->n;j++){
+        total+=ob->b[j].rows;
+    }
+    if(total==E.numrows){
+        while(p<ob->n&&p<nb.n&&editor_disk_same(&ob->b[p],&nb.b[p])){
+            prows+=ob->b[p++].rows;
+        }
+        while(s<ob->n-p&&s<nb.n-p&&editor_disk_same(&ob->b[ob->n-1-s],&nb.b[nb.n-1-s])){
+            srows+=ob->b[ob->n-1-s++].rows;
+        }
+    }
+    long long start=p<nb.n?nb.b[p].off:size,end=s?nb.b[nb.n-s].off:size;
+    int oldrows=E.numrows-prows-srows;
+    char *text=malloc(end-start+1);
+    size_t len=0;
+    if(text==NULL||pread(fileno(fp),text,end-start,start)!=end-start){
+        free(text);
+        fclose(fp);
+        editor_blocks_free(&nb);
+        return 0;
+    }
+    fclose(fp);
+    len=end-start;
+    int cr=memchr(text,'\r',len)!=NULL;
+    if(cr){
+        len=editor_strip_cr(text,len);
+    }
+    int cy=E.cy,rowoff=E.rowoff,newrows=0,nl=len>0&&text[len-1]=='\n';
+    editor_undo_boundary(UNDO_KIND_OTHER); // the reload is one action,Ctrl+Z brings back what was there
+    if(oldrows>0){
+        editor_DelRows(prows,oldrows);
+    }
+    if(len>0){
+        newrows=editor_InsertRows(prows,text,len-nl);
+    }
+    free(text);
+    // Rows after the change moved by this many bytes in the file
+    long long shift=size-(ob->n?ob->b[ob->n-1].off+ob->b[ob->n-1].len:0);
+    editor_kill_disk();
+    for(j=prows+newrows;j<E.numrows;j++){
+        struct rowbuf *b=editor_rowbuf(E.row[j].chars);
+        if(b->disk>=0&&__atomic_load_n(&b->refs,__ATOMIC_ACQUIRE)>1){
+            b->disk=-1; // another row may share it,don't shift it twice
+        }else if(b->disk>=0){
+            b->disk+=shift;
+        }
+    }
+    if(!cr){
+        long long off=start;
+        for(j=prows;j<prows+newrows-!nl;j++){ // a last line without its newline is not on disk as a row
+            editor_rowbuf(E.row[j].chars)->disk=off;
+            off+=E.row[j].size+1;
+        }
+    }
+    // Keep the cursor on the same text when it was outside the change
+    if(cy>=prows+oldrows){
+        E.cy=cy+newrows-oldrows;
+    }else if(cy>=prows+newrows){
+        E.cy=prows+newrows;
+    }
+    if(rowoff>=prows+oldrows){
+        E.rowoff=rowoff+newrows-oldrows;
+    }
+    editor_undo_clampcursor();
+    editor_blocks_free(ob);
+    *ob=nb;
+    E.disk=st;
+    E.disk_ok=1;
+    editor_disk_path(E.filename);
+    E.dirty=0;
+    E.disk_changed=0;
+    editor_undo_journal_saved(E.filename,key,E.undo.pos);
+    editor_swap_flush(0);
+    editor_swap_saved(key,E.swap.off);
+    editor_setstatus_Message("File changed on disk: %d lines reloaded",newrows);
+    return 1;
+}
+
+// Has the file changed since it was read or saved? Returns 1 when the screen should change.
+int editor_disk_check(){
+    struct stat st;
+    E.disk_check_at=editor_now_ms();
+    if(!E.disk_ok||E.filename==NULL||E.save.active||E.follow.active||stat(E.filename,&st)==-1){
+        return 0; // a follow mode keeps up by itself
+    }
+    if(st.st_dev==E.disk.st_dev&&st.st_ino==E.disk.st_ino&&st.st_size==E.disk.st_size&&
+       st.st_mtim.tv_sec==E.disk.st_mtim.tv_sec&&st.st_mtim.tv_nsec==E.disk.st_mtim.tv_nsec){
+        return 0;
+    }
+    if(E.dirty){
+        if(!E.disk_changed){
+            E.disk_changed=1;
+            editor_setstatus_Message("File changed on disk! Saving will overwrite it");
+            return 1;
+        }
+        return 0;
+    }
+    return editor_disk_reload();
+}
+
+/*index cache*/
+// With DELULU_CACHE=1 in the environment,opening a file remembers its line offsets,content hash,
+// change-detection blocks and where the cursor was in $XDG_CACHE_HOME/delulu (~/.cache/delulu).
+// The next open of the same file finds the lines without scanning or hashing a byte: it only has
+// to read them. The cache belongs to a file of one size,inode and mtime whose contents hash the
+// same at DELULU_CACHE_SAMPLES places.
+
+int editor_cache_enabled(){
+    char *env=getenv("DELULU_CACHE");
+    return env&&atoi(env)!=0;
+}
+
+// Cache file for filename,named by a hash of its real path. NULL when caching is off.
+char *editor_cache_path(const char *filename){
+    if(!editor_cache_enabled()){
+        return NULL;
+    }
+    char dir[4096];
+    char *xdg=getenv("XDG_CACHE_HOME"),*home=getenv("HOME");
+    if(xdg&&xdg[0]=='/'){
+        snprintf(dir,sizeof(dir),"%s",xdg);
+    }else if(home&&home[0]=='/'){
+        snprintf(dir,sizeof(dir),"%s/.cache",home);
+    }else{
+        return NULL;
+    }
+    char *real=realpath(filename,NULL);
+    if(real==NULL){
+        return NULL;
+    }
+    unsigned long long h=editor_hash(DELULU_HASH_INIT,real,strlen(real));
+    free(real);
+    mkdir(dir,0700);
+    size_t len=strlen(dir)+sizeof("/delulu/0123456789abcdef.idx");
+    char *path=malloc(len);
+    snprintf(path,len,"%s/delulu",dir);
+    if(mkdir(path,0700)==-1&&errno!=EEXIST){
+        free(path);
+        return NULL;
+    }
+    snprintf(path,len,"%s/delulu/%016llx.idx",dir,h);
+    return path;
+}
+
+unsigned long long editor_cache_sample(int fd,long long size){
+    char buf[4096];
+    unsigned long long h=DELULU_HASH_INIT;
+    int j;
+    for(j=0;j<DELULU_CACHE_SAMPLES;j++){
+        long long off=size>(long long)sizeof(buf)?(size-(long long)sizeof(buf))/(DELULU_CACHE_SAMPLES-1)*j:0;
+        ssize_t n=pread(fd,buf,sizeof(buf),off);
+        if(n>0){
+            h=editor_hash(h,buf,n);
+        }
+        if(size<=(long long)sizeof(buf)){
+            break;
+        }
+    }
+    return h;
+}
+
+// Write the cache for the file E.disk describes. offs holds rows+1 line start offsets.
+// It goes to a temporary file that is renamed over the old cache,so a reader never sees half of one.
+void editor_cache_write(const char *filename,const long long *offs,long long rows,int partial,unsigned long long key){
+    struct cache_hdr h;
+    char *path=editor_cache_path(filename);
+    if(path==NULL){
+        return;
+    }
+    char *tmp=malloc(strlen(path)+sizeof(".XXXXXX"));
+    sprintf(tmp,"%s.XXXXXX",path);
+    int fd=mkstemp(tmp),file=open(filename,O_RDONLY|O_CLOEXEC);
+    if(fd==-1||file==-1){
+        if(fd!=-1){
+            close(fd);
+            unlink(tmp);
+        }
+        if(file!=-1){
+            close(file);
+        }
+        free(tmp);
+        free(path);
+        return; // no cache,the next open just takes longer
+    }
+    memset(&h,0,sizeof(h));
+    memcpy(h.magic,CACHE_MAGIC,sizeof(h.magic));
+    h.size=E.disk.st_size;
+    h.dev=E.disk.st_dev;
+    h.ino=E.disk.st_ino;
+    h.mtime_sec=E.disk.st_mtim.tv_sec;
+    h.mtime_nsec=E.disk.st_mtim.tv_nsec;
+    h.sample=editor_cache_sample(file,E.disk.st_size);
+    h.key=key;
+    h.rows=rows;
+    h.blocks=E.blocks.n;
+    h.partial=partial;
+    h.cy=E.cy;
+    h.cx=E.cx;
+    h.rowoff=E.rowoff;
+    h.coloff=E.coloff;
+    close(file);
+    struct iovec iov[3]={{&h,sizeof(h)},{(void *)offs,sizeof(*offs)*(rows+1)},{E.blocks.b,sizeof(*E.blocks.b)*E.blocks.n}};
+    int ok=writev(fd,iov,3)==(ssize_t)(iov[0].iov_len+iov[1].iov_len+iov[2].iov_len);
+    if(close(fd)==-1||!ok||rename(tmp,path)==-1){
+        unlink(tmp);
+    }
+    free(tmp);
+    free(path);
+}
+
+// Remember where the cursor is,for the next open (used when quitting)
+void editor_cache_position(){
+    if(E.filename==NULL||E.view.active){
+        return;
+    }
+    char *path=editor_cache_path(E.filename);
+    if(path==NULL){
+        return;
+    }
+    int fd=open(path,O_RDWR|O_NOFOLLOW|O_CLOEXEC);
+    free(path);
+    struct cache_hdr h;
+    if(fd==-1){
+        return;
+    }
+    if(pread(fd,&h,sizeof(h),0)==sizeof(h)&&memcmp(h.magic,CACHE_MAGIC,sizeof(h.magic))==0){
+        h.cy=E.cy;
+        h.cx=E.cx;
+        h.rowoff=E.rowoff;
+        h.coloff=E.coloff;
+        if(pwrite(fd,&h,sizeof(h),0)!=sizeof(h)){
+            // only a cursor position lost
+        }
+    }
+    close(fd);
+}
+
+// Build the rows of filename (open as fp) from its cache. Returns 0 when there is no usable cache.
+int editor_cache_load(const char *filename,FILE *fp,unsigned long long *key){
+    char *path=editor_cache_path(filename);
+    if(path==NULL){
+        return 0;
+    }
+    int fd=open(path,O_RDONLY|O_NOFOLLOW|O_CLOEXEC),file=fileno(fp);
+    free(path);
+    struct stat st,cst;
+    struct cache_hdr *h;
+    if(fd==-1){
+        return 0;
+    }
+    if(fstat(fd,&cst)==-1||fstat(file,&st)==-1||cst.st_size<(off_t)sizeof(*h)){
+        close(fd);
+        return 0;
+    }
+    void *map=mmap(NULL,cst.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    if(map==MAP_FAILED){
+        return 0;
+    }
+    h=map;
+    const long long *offs=(const long long *)(h+1);
+    const struct disk_block *blocks;
+    long long i,j;
+    if(memcmp(h->magic,CACHE_MAGIC,sizeof(h->magic))!=0||h->rows<0||h->blocks<0||h->rows>cst.st_size||h->blocks>cst.st_size||
+       (unsigned long long)cst.st_size!=sizeof(*h)+sizeof(*offs)*(h->rows+1)+sizeof(*blocks)*h->blocks||
+       h->size!=(unsigned long long)st.st_size||h->dev!=(unsigned long long)st.st_dev||h->ino!=st.st_ino||h->mtime_sec!=(unsigned long long)st.st_mtim.tv_sec||
+       h->mtime_nsec!=(unsigned long long)st.st_mtim.tv_nsec||offs[0]!=0||offs[h->rows]!=st.st_size||
+       h->sample!=editor_cache_sample(file,st.st_size)){
+        munmap(map,cst.st_size);
+        return 0; // a different file now,editor_open reads it the slow way and writes a new cache
+    }
+    for(i=0;i<h->rows;i++){
+        if(offs[i]>=offs[i+1]){
+            munmap(map,cst.st_size);
+            return 0; // every line takes at least one byte,anything else is a damaged cache
+        }
+    }
+    blocks=(const struct disk_block *)(offs+h->rows+1);
+    // Read as many whole lines as fit in the buffer at a time and make them rows
+    size_t cap=DELULU_SAVE_CHUNK;
+    char *buf=malloc(cap);
+    i=0;
+    E.row=realloc(E.row,sizeof(erow)*(h->rows?h->rows:1));
+    editor_rows_moved(E.numrows,h->rows);
+    while(buf&&i<h->rows){
+        long long end=i+1;
+        if((size_t)(offs[end]-offs[i])>cap){
+            cap=offs[end]-offs[i];
+            buf=realloc(buf,cap);
+        }
+        while(end<h->rows&&(size_t)(offs[end+1]-offs[i])<=cap){
+            end++;
+        }
+        if(buf==NULL||pread(file,buf,offs[end]-offs[i],offs[i])!=offs[end]-offs[i]){
+            break;
+        }
+        for(j=i;j<end;j++){
+            char *line=buf+(offs[j]-offs[i]);
+            long long raw=offs[j+1]-offs[j],len=raw;
+            while(len>0&&(line[len-1]=='\n'||line[len-1]=='\r')){
+                len--;
+            }
+            erow *row=&E.row[E.numrows++];
+            row->size=len;
+            row->chars=editor_chars_new(line,len);
+            row->rsize=0;
+            row->render=NULL;
+            row->wrap=NULL;
+            row->wrapw=0;
+            editor_UpdateRows(row);
+            if(raw==len+1&&line[len]=='\n'){
+                editor_rowbuf(row->chars)->disk=offs[j]; // saving writes back exactly these bytes
+            }
+        }
+        i=end;
+    }
+    free(buf);
+    if(i<h->rows){
+        // The file could not be read after all: start over without the cache
+        while(E.numrows>0){
+            editorFreerow(&E.row[--E.numrows]);
+        }
+        munmap(map,cst.st_size);
+        return 0;
+    }
+    editor_blocks_free(&E.blocks);
+    E.blocks.n=E.blocks.cap=h->blocks;
+    E.blocks.b=malloc(sizeof(*blocks)*(h->blocks?h->blocks:1));
+    memcpy(E.blocks.b,blocks,sizeof(*blocks)*h->blocks);
+    E.follow.off=st.st_size;
+    E.follow.partial=h->partial;
+    E.disk=st;
+    E.disk_ok=1;
+    editor_disk_path(filename);
+    *key=h->key;
+    E.cy=h->cy<=E.numrows&&h->cy>=0?h->cy:0;
+    E.rowoff=h->rowoff<=E.cy&&h->rowoff>=0?h->rowoff:E.cy;
+    E.cx=E.cy<E.numrows&&h->cx>=0&&h->cx<=E.row[E.cy].size?h->cx:0;
+    E.coloff=h->coloff>=0?h->coloff:0;
+    munmap(map,cst.st_size);
+    return 1;
+}
+
+/*background save*/
+// Ctrl+S snapshots the row table (an array of shared chars pointers,no text is copied) and hands
+// it to a writer thread. Edits keep going against the live rows: a shared buffer is copied the
+// first time it is written to (editor_row_reserve),so the snapshot never changes under the writer.
+// Each row buffer also remembers where its bytes already are in the file (disk offset,-1 once
+// modified),which lets the writer skip everything that did not change.
+// Write out whatever is gathered in buf
+int editor_save_putbuf(struct editor_save_job *job,int fd,char *buf,size_t *used){
+    if(*used==0){
+        return 0;
+    }
+    if(write(fd,buf,*used)!=(ssize_t)*used){
+        return -1;
+    }
+    __atomic_add_fetch(&job->written,*used,__ATOMIC_RELAXED);
+    job->rewritten+=*used;
+    *used=0;
+    return 0;
+}
+
+// Append len bytes at off of the old file to fd without passing them through user space.
+// copy_file_range lets the filesystem share the blocks (reflink) or copy them in the kernel.
+int editor_save_copy(struct editor_save_job *job,int src,int fd,off_t off,size_t len){
+    while(len>0){
+        ssize_t n=copy_file_range(src,&off,fd,NULL,len,0);
+        if(n==-1&&(errno==EXDEV||errno==ENOSYS||errno==EINVAL||errno==EOPNOTSUPP)){
+            // No kernel copy across these files: fall back to a bounce buffer
+            char tmp[65536];
+            n=pread(src,tmp,len<sizeof(tmp)?len:sizeof(tmp),off);
+            if(n>0&&write(fd,tmp,n)!=n){
+                return -1;
+            }
+            off+=n>0?n:0;
+        }
+        if(n<=0){
+            return -1; // the old file got shorter under us
+        }
+        len-=n;
+        __atomic_add_fetch(&job->written,n,__ATOMIC_RELAXED);
+    }
+    return 0;
+}
+
+// Rows still matching the file on disk (disk>=0) and sitting at the same offset need no I/O,
+// so when every clean row keeps its offset only the modified rows are pwrite'n in place
+int editor_save_inplace(struct editor_save_job *job,char *buf){
+    int fd=open(job->filename,O_WRONLY);
+    int j,start=-1;
+    size_t used=0;
+    if(fd==-1){
+        return -1;
+    }
+    for(j=0;j<=job->numrows;j++){
+        if(j<job->numrows&&job->rows[j].disk<0){
+            size_t need=job->rows[j].size+1;
+            if(used&&used+need>DELULU_SAVE_CHUNK){
+                // Chunk full: write what we have of this run and continue the run after it
+                if(pwrite(fd,buf,used,job->rows[start].newoff)!=(ssize_t)used){
+                    break;
+                }
+                job->rewritten+=used;
+                used=0;
+                start=-1;
+            }
+            if(start==-1){
+                start=j;
+            }
+            if(need>DELULU_SAVE_CHUNK){
+                struct iovec iov[2]={{job->rows[j].chars,job->rows[j].size},{"\n",1}};
+                if(pwritev(fd,iov,2,job->rows[j].newoff)!=(ssize_t)need){
+                    break;
+                }
+                job->rewritten+=need;
+                start=-1;
+            }else{
+                memcpy(&buf[used],job->rows[j].chars,job->rows[j].size);
+                buf[used+job->rows[j].size]='\n';
+                used+=need;
+            }
+        }else if(used){
+            // End of a run of modified rows
+            if(pwrite(fd,buf,used,job->rows[start].newoff)!=(ssize_t)used){
+                break;
+            }
+            job->rewritten+=used;
+            used=0;
+            start=-1;
+        }
+        if(j<job->numrows){
+            __atomic_add_fetch(&job->written,job->rows[j].size+1,__ATOMIC_RELAXED);
+        }
+    }
+    if(j<=job->numrows||ftruncate(fd,job->total)==-1||fsync(fd)==-1){
+        int err=errno;
+        close(fd);
+        errno=err;
+        return -1;
+    }
+    return close(fd);
+}
+
+// Make a rename in the directory of path durable
+void editor_save_syncdir(const char *path){
+    const char *slash=strrchr(path,'/');
+    char dir[4096];
+    snprintf(dir,sizeof(dir),"%.*s",slash?(slash==path?1:(int)(slash-path)):1,slash?path:".");
+    int fd=open(dir,O_RDONLY|O_DIRECTORY|O_CLOEXEC);
+    if(fd!=-1){
+        fsync(fd);
+        close(fd);
+    }
+}
+
+// Scratch file for a rebuild that has to be copied back,outside the file's directory
+int editor_save_scratch(){
+    const char *dir=getenv("TMPDIR");
+    char path[4096];
+    snprintf(path,sizeof(path),"%s/.delulu-save.XXXXXX",dir&&dir[0]?dir:"/tmp");
+    int fd=mkstemp(path);
+    if(fd!=-1){
+        unlink(path); // gone as soon as it is closed
+    }
+    return fd;
+}
+
+// Build the new contents in a temporary: modified rows are written,runs of unchanged rows are
+// copied from the old file. A temporary next to the file is renamed over it when the new file
+// can be just like the old one: the only link to it,no extended attributes (ACLs),and fchown
+// gives it the same owner and group. Otherwise,or when the directory isn't writable,the rows
+// are built in a scratch file and copied back into the original inode. A symlink is followed
+// to the file it names.
+int editor_save_rebuild(struct editor_save_job *job,char *buf){
+    char *real=realpath(job->filename,NULL);
+    const char *target=real?real:job->filename;
+    char *tmp=editor_sidecar_path(target,".delulu-save");
+    struct stat st;
+    int exists=stat(target,&st)==0;
+    int replace=!exists||(st.st_nlink==1&&listxattr(target,NULL,0)<=0);
+    int fd=-1,src=-1,dst=-1;
+    off_t span=-1;  // Old-file run waiting to be copied
+    size_t spanlen=0,used=0;
+    int j;
+    if(replace){
+        unlink(tmp); // left over from a save that died,or planted: a fresh file either way
+        fd=open(tmp,O_RDWR|O_CREAT|O_EXCL|O_NOFOLLOW|O_CLOEXEC,0644);
+        if(fd!=-1&&exists&&(fchown(fd,st.st_uid,st.st_gid)==-1||fchmod(fd,st.st_mode&07777)==-1)){
+            close(fd); // it could not be made to look like the file it replaces
+            unlink(tmp);
+            fd=-1;
+        }
+    }
+    if(fd==-1){
+        if(!exists){
+            goto fail; // nowhere to put a new file
+        }
+        replace=0;
+        free(tmp);
+        tmp=NULL;
+        fd=editor_save_scratch();
+        if(fd==-1){
+            goto fail;
+        }
+    }
+    src=job->disk_ok?open(target,O_RDONLY|O_CLOEXEC):-1;
+    for(j=0;j<job->numrows;j++){
+        size_t need=job->rows[j].size+1;
+        if(src!=-1&&job->rows[j].disk>=0){
+            if(span>=0&&span+(off_t)spanlen==job->rows[j].disk){
+                spanlen+=need;
+                continue;
+            }
+            if(editor_save_putbuf(job,fd,buf,&used)==-1||(span>=0&&editor_save_copy(job,src,fd,span,spanlen)==-1)){
+                goto fail;
+            }
+            span=job->rows[j].disk;
+            spanlen=need;
+            continue;
+        }
+        if(span>=0){
+            if(editor_save_putbuf(job,fd,buf,&used)==-1||editor_save_copy(job,src,fd,span,spanlen)==-1){
+                goto fail;
+            }
+            span=-1;
+        }
+        if(used+need>DELULU_SAVE_CHUNK&&editor_save_putbuf(job,fd,buf,&used)==-1){
+            goto fail;
+        }
+        if(need>DELULU_SAVE_CHUNK){
+            // A row bigger than the chunk goes out on its own
+            struct iovec iov[2]={{job->rows[j].chars,job->rows[j].size},{"\n",1}};
+            if(writev(fd,iov,2)!=(ssize_t)need){
+                goto fail;
+            }
+            __atomic_add_fetch(&job->written,need,__ATOMIC_RELAXED);
+            job->rewritten+=need;
+            continue;
+        }
+        memcpy(&buf[used],job->rows[j].chars,job->rows[j].size);
+        buf[used+job->rows[j].size]='\n';
+        used+=need;
+    }
+    if(editor_save_putbuf(job,fd,buf,&used)==-1||(span>=0&&editor_save_copy(job,src,fd,span,spanlen)==-1)){
+        goto fail;
+    }
+    if(replace){
+        if(fsync(fd)==-1||close(fd)==-1){
+            fd=-1;
+            goto fail;
+        }
+        fd=-1;
+        if(rename(tmp,target)==-1){
+            goto fail;
+        }
+        editor_save_syncdir(target);
+    }else{
+        // Into the file itself,its inode keeps its owner,links and attributes
+        dst=open(target,O_WRONLY|O_CLOEXEC);
+        __atomic_store_n(&job->written,0,__ATOMIC_RELAXED); // progress starts over for the copy
+        if(dst==-1||editor_save_copy(job,fd,dst,0,job->total)==-1||ftruncate(dst,job->total)==-1||
+           fsync(dst)==-1){
+            goto fail;
+        }
+        close(dst);
+        close(fd);
+        job->rewritten=job->total;
+    }
+    if(src!=-1){
+        close(src);
+    }
+    free(tmp);
+    free(real);
+    return 0;
+fail:
+    job->err=errno?errno:EIO;
+    if(fd!=-1){
+        close(fd);
+    }
+    if(src!=-1){
+        close(src);
+    }
+    if(dst!=-1){
+        close(dst);
+    }
+    if(tmp){
+        unlink(tmp);
+    }
+    free(tmp);
+    free(real);
+    errno=job->err;
+    return -1;
+}
+
+void *editor_save_thread(void *arg){
+    struct editor_save_job *job=arg;
+    char *buf=malloc(DELULU_SAVE_CHUNK);
+    struct stat st;
+    long long off=0;
+    int j,inplace;
+    // The recorded disk offsets only mean something if the file is still the one we read
+    job->disk_ok=job->disk_ok&&stat(job->filename,&st)==0&&st.st_dev==job->disk.st_dev&&
+                 st.st_ino==job->disk.st_ino&&st.st_size==job->disk.st_size&&
+                 st.st_mtim.tv_sec==job->disk.st_mtim.tv_sec&&st.st_mtim.tv_nsec==job->disk.st_mtim.tv_nsec;
+    inplace=job->disk_ok;
+    job->key=DELULU_HASH_INIT;
+    for(j=0;j<job->numrows;j++){
+        job->rows[j].newoff=off;
+        if(!job->disk_ok){
+            job->rows[j].disk=-1;
+        }else if(job->rows[j].disk>=0&&job->rows[j].disk!=off){
+            inplace=0; // an unchanged row moved,the file has to be rebuilt
+        }
+        job->key=editor_hash(editor_hash(job->key,job->rows[j].chars,job->rows[j].size),"\n",1);
+        editor_blocks_add(&job->blocks,job->rows[j].chars,job->rows[j].size,1);
+        off+=job->rows[j].size+1;
+    }
+    job->inplace=inplace;
+    if(buf==NULL||(inplace?editor_save_inplace(job,buf):editor_save_rebuild(job,buf))==-1){
+        job->err=errno?errno:EIO;
+    }else if(stat(job->filename,&st)==0){
+        job->disk=st;
+    }
+    free(buf);
+    __atomic_store_n(&job->done,1,__ATOMIC_RELEASE);
+    if(write(E.wakefd[1],"s",1)==-1){
+        // pipe full: the event loop is awake anyway
+    }
+    return NULL;
+}
+
+// Polled from the input loop: returns 1 when the status bar has something new to show
+int editor_save_tick(){
+    struct editor_save_job *job=&E.save;
+    if(!job->active){
+        return 0;
+    }
+    if(!__atomic_load_n(&job->done,__ATOMIC_ACQUIRE)){
+        return 1; // progress moved on
+    }
+    pthread_join(job->thread,NULL);
+    int j;
+    long long *offs=!job->err&&job->total>=DELULU_CACHE_MIN&&editor_cache_enabled()?malloc(sizeof(*offs)*(job->numrows+1)):NULL; // for the index cache
+    editor_kill_disk(); // cut rows the save wrote get their new offsets back just below
+    for(j=0;j<job->numrows;j++){
+        if(offs){
+            offs[j]=job->rows[j].newoff;
+        }
+        if(!job->err){
+            editor_rowbuf(job->rows[j].chars)->disk=job->rows[j].newoff; // live rows still sharing it are on disk there now
+        }
+        editor_chars_free(job->rows[j].chars);
+    }
+    free(job->rows);
+    job->rows=NULL;
+    job->active=0;
+    if(job->err){
+        editor_setstatus_Message("Can't save I/O error: %s",strerror(job->err));
+    }else{
+        E.dirty-=job->dirty; // edits made while saving are still unsaved
+        if(E.dirty<0){
+            E.dirty=0;
+        }
+        editor_undo_journal_saved(job->filename,job->key,job->upos);
+        editor_swap_saved(job->key,job->swapoff);
+        E.disk=job->disk;
+        E.disk_ok=1;
+        editor_disk_path(job->filename);
+        editor_follow_saved(&job->disk);
+        editor_blocks_free(&E.blocks);
+        E.blocks=job->blocks; // the file is what was just written
+        memset(&job->blocks,0,sizeof(job->blocks));
+        E.disk_changed=0;
+        if(offs){
+            offs[job->numrows]=job->total;
+            editor_cache_write(job->filename,offs,job->numrows,0,job->key);
+        }
+        if(job->rewritten==job->total){
+            editor_setstatus_Message("%lld bytes written to disk",job->total);
+        }else{
+            editor_setstatus_Message("%lld bytes saved, %lld rewritten%s",job->total,job->rewritten,
+                                     job->inplace?" in place":"");
+        }
+    }
+    free(offs);
+    editor_blocks_free(&job->blocks);
+    free(job->filename);
+    job->filename=NULL;
+    return 1;
+}
+
+// Block until a running save has finished (used before exiting)
+void editor_save_wait(){
+    while(E.save.active){
+        if(!__atomic_load_n(&E.save.done,__ATOMIC_ACQUIRE)){
+            usleep(10000);
+            continue;
+        }
+        editor_save_tick();
+    }
+}
+
+void editor_save(){
+    if(E.save.active){
+        editor_setstatus_Message("Save already in progress");
+        return;
+    }
+    if(E.filename==NULL){
+        E.filename=editorPrompt("Save as: %s (ESC to cancel)");
+        if(E.filename==NULL){
+            editor_setstatus_Message("Save aborted");
+            return;
+        }
+    }
+    editor_disk_check();
+    if(E.disk_changed==1){
+        E.disk_changed=2;
+        editor_setstatus_Message("File changed on disk since it was read! Ctrl+S again to overwrite it");
+        return;
+    }
+    struct editor_save_job *job=&E.save;
+    memset(job,0,sizeof(*job));
+    job->rows=malloc(sizeof(*job->rows)*(E.numrows?E.numrows:1));
+    int j;
+    for(j=0;j<E.numrows;j++){
+        job->rows[j].chars=editor_chars_share(E.row[j].chars);
+        job->rows[j].size=E.row[j].size;
+        job->rows[j].disk=editor_rowbuf(E.row[j].chars)->disk;
+        job->total+=E.row[j].size+1;
+    }
+    job->numrows=E.numrows;
+    job->filename=strdup(E.filename);
+    job->dirty=E.dirty;
+    job->upos=E.undo.pos;
+    job->disk=E.disk;
+    job->disk_ok=E.disk_ok&&E.disk_path!=NULL&&strcmp(E.disk_path,job->filename)==0;
+    editor_swap_flush(0);
+    job->swapoff=E.swap.fd!=-1?E.swap.off:-1; // a swap created by edits during the save is all newer
+    job->active=1;
+    if(pthread_create(&job->thread,NULL,editor_save_thread,job)!=0){
+        job->err=errno;
+        job->done=1;
+        editor_save_tick();
+        return;
+    }
+    editor_setstatus_Message("Saving %s...",E.filename);
+    //O_RDWR -> for read and write
+    //O_CREAT -> extra arg to contain mode(the permission) the new file should have 
+    //0644 -> std permissions
+}
+
+/*Append Buffer*/
+// This section is for handling the append buffer, which is used to efficiently build strings for output
+struct abuf
+{
+    char *b; // Pointer to the buffer
+    int len; // Length of the buffer
+    int cap; // Bytes allocated,frame buffers keep theirs from one frame to the next
+    long long key_at; // Frames only: when the oldest key they show was read,0 if none
+};
+#define ABUF_INIT {NULL, 0, 0, 0} // Initialize the append buffer
+// append buff consist of ptr to our buff mem and length ,we defined
+// abuf_init const representing empty buffer which acts as constructor
+void ab_append(struct abuf *ab, const char *s, int len)
+{
+    if (ab->len + len > ab->cap)
+    {
+        int cap = ab->cap ? ab->cap * 2 : 4096; // Grow geometrically,a reused frame stops growing after the first few
+        while (cap < ab->len + len)
+        {
+            cap *= 2;
+        }
+        char *new = realloc(ab->b, cap); // Reallocate memory for the buffer
+        if (new == NULL)
+        {
+            return; // If memory allocation fails, do nothing
+        }
+        ab->b = new; // Update the buffer pointer
+        ab->cap = cap;
+    }
+    memcpy(&ab->b[ab->len], s, len); // Copy the new string into the buffer
+    ab->len += len;                  // Update the length of the buffer
+}
+
+void ab_free(struct abuf *ab)
+{
+    free(ab->b);  // Free the memory allocated for the buffer
+    ab->b = NULL; // Set the pointer to NULL to avoid dangling pointer
+    ab->len = 0;  // Reset the length to 0
+    ab->cap = 0;
+}
+
+/*viewer*/
+// delulu -R file pages a file in instead of loading it,so memory stays the same for a 50 GB log as
+// for a small one. Lines are read with pread through a small LRU of fixed-size blocks and the
+// screen is positioned by the byte offset of its first line. A thread counts lines in the
+// background and keeps the offset of every stride-th line; when the table fills up the stride
+// doubles and every other entry goes. Until it gets there,line numbers are estimated from the
+// average line length seen so far (shown with a ~) and corrected once the indexer catches up.
+struct view_block *editor_view_block(off_t off){
+    struct editor_view *v=&E.view;
+    struct view_block *b,*lru=&v->block[0];
+    int j;
+    off-=off%DELULU_VIEW_BLOCK;
+    for(j=0;j<DELULU_VIEW_BLOCKS;j++){
+        b=&v->block[j];
+        if(b->data&&b->off==off){
+            b->used=++v->clock;
+            return b;
+        }
+        if(b->data==NULL||b->used<lru->used){
+            lru=b; // an empty slot,or the one used longest ago
+        }
+        if(b->data==NULL){
+            break;
+        }
+    }
+    if(lru->data==NULL&&(lru->data=malloc(DELULU_VIEW_BLOCK))==NULL){
+        die("malloc");
+    }
+    ssize_t n=pread(v->fd,lru->data,DELULU_VIEW_BLOCK,off);
+    if(n==-1){
+        die("pread");
+    }
+    lru->off=off;
+    lru->len=n;
+    lru->used=++v->clock;
+    return lru;
+}
+
+// The line starting at off: copies up to cap of its bytes into buf and returns how many,
+// *next gets the offset of the line after it (the file size at the end)
+int editor_view_line(off_t off,char *buf,int cap,off_t *next){
+    int n=0;
+    while(off<E.view.size){
+        struct view_block *b=editor_view_block(off);
+        int at=off-b->off;
+        if(at>=b->len){
+            break; // the file shrank under us
+        }
+        char *nl=memchr(b->data+at,'\n',b->len-at);
+        int len=(nl?nl-b->data:b->len)-at;
+        if(n<cap){
+            int copy=len<cap-n?len:cap-n;
+            memcpy(buf+n,b->data+at,copy);
+            n+=copy;
+        }
+        off+=len;
+        if(nl){
+            off++;
+            break;
+        }
+    }
+    *next=off<E.view.size?off:E.view.size;
+    return n;
+}
+
+// Offset of the start of the line holding the byte at off
+off_t editor_view_linestart(off_t off){
+    while(off>0){
+        struct view_block *b=editor_view_block(off-1);
+        int at=off-1-b->off;
+        char *nl=memrchr(b->data,'\n',at+1);
+        if(nl){
+            return b->off+(nl-b->data)+1;
+        }
+        off=b->off;
+    }
+    return 0;
+}
+
+void *editor_view_thread(void *arg){
+    struct editor_view *v=arg;
+    char *buf=malloc(DELULU_VIEW_READ);
+    off_t off=0;
+    long long lines=0;
+    char last='\n';
+    while(buf&&off<v->size){
+        ssize_t n=pread(v->fd,buf,DELULU_VIEW_READ,off);
+        if(n<=0){
+            break;
+        }
+        char *p=buf,*end=buf+n;
+        pthread_mutex_lock(&v->lock);
+        while((p=memchr(p,'\n',end-p))!=NULL){
+            p++;
+            lines++;
+            if(lines%v->stride==0){
+                if(v->nindex==DELULU_VIEW_INDEX_MAX){
+                    int j;
+                    for(j=0;j<v->nindex/2;j++){
+                        v->index[j]=v->index[2*j]; // keep every other line offset
+                    }
+                    v->nindex/=2;
+                    v->stride*=2;
+                }
+                if(lines%v->stride==0){
+                    v->index[v->nindex++]=off+(p-buf);
+                }
+            }
+        }
+        last=buf[n-1];
+        off+=n;
+        v->lines=lines;
+        v->indexed=off;
+        pthread_mutex_unlock(&v->lock);
+    }
+    free(buf);
+    pthread_mutex_lock(&v->lock);
+    v->total=lines+(off>0&&last!='\n'); // a last line without a newline counts too
+    pthread_mutex_unlock(&v->lock);
+    __atomic_store_n(&v->done,1,__ATOMIC_RELEASE);
+    if(write(E.wakefd[1],"v",1)==-1){
+        // pipe full: the event loop is awake anyway
+    }
+    return NULL;
+}
+
+// Offset of line *at (0-based): exact from the index once the indexer has been past it,
+// estimated from the average line length before that. An exact seek past the end stops on
+// the last line and leaves its number in *at.
+off_t editor_view_seek(long long *at,int *exact){
+    struct editor_view *v=&E.view;
+    long long line=*at;
+    pthread_mutex_lock(&v->lock);
+    long long lines=v->lines,stride=v->stride;
+    off_t indexed=v->indexed,off=0;
+    int known=line<lines||v->total>=0;
+    if(known){
+        long long j=line/stride;
+        if(j>=v->nindex){
+            j=v->nindex-1;
+        }
+        off=v->index[j];
+        line-=j*stride;
+    }
+    pthread_mutex_unlock(&v->lock);
+    if(!known){
+        // Past what has been indexed: guess from the average line length so far,or from the first block
+        off_t avg;
+        if(lines>0){
+            avg=indexed/lines;
+        }else{
+            struct view_block *b=editor_view_block(0);
+            int nl=0,j;
+            for(j=0;j<b->len;j++){
+                nl+=b->data[j]=='\n';
+            }
+            avg=nl?b->len/nl:b->len;
+            indexed=0;
+        }
+        if(avg<1){
+            avg=1;
+        }
+        off=indexed+(line-lines)*avg;
+        if(off<indexed||off>=v->size){
+            off=v->size>0?v->size-1:0;
+        }
+        *exact=0;
+        return editor_view_linestart(off);
+    }
+    while(line>0&&off<v->size){
+        off_t next;
+        editor_view_line(off,NULL,0,&next);
+        if(next>=v->size){
+            break;
+        }
+        off=next;
+        line--;
+    }
+    *at-=line; // the file may end before the line asked for
+    *exact=1;
+    return off;
+}
+
+// Line number of the first line on screen,exact if the indexer has been past it
+void editor_view_locate(){
+    struct editor_view *v=&E.view;
+    if(v->exact){
+        return;
+    }
+    pthread_mutex_lock(&v->lock);
+    if(v->top>=v->indexed&&v->total<0){
+        long long lines=v->lines;
+        off_t indexed=v->indexed;
+        pthread_mutex_unlock(&v->lock);
+        long long avg=lines?indexed/lines:1;
+        v->line=lines+(v->top-indexed)/(avg?avg:1);
+        return;
+    }
+    int lo=0,hi=v->nindex-1; // last index entry at or before top
+    while(lo<hi){
+        int mid=(lo+hi+1)/2;
+        if(v->index[mid]<=v->top){
+            lo=mid;
+        }else{
+            hi=mid-1;
+        }
+    }
+    off_t off=v->index[lo];
+    long long line=lo*v->stride;
+    pthread_mutex_unlock(&v->lock);
+    while(off<v->top){
+        editor_view_line(off,NULL,0,&off);
+        line++;
+    }
+    v->line=line;
+    v->exact=1;
+}
+
+void editor_view_open(char *filename){
+    struct editor_view *v=&E.view;
+    struct stat st;
+    free(E.filename);
+    E.filename=strdup(filename);
+    v->fd=open(filename,O_RDONLY|O_CLOEXEC);
+    if(v->fd==-1||fstat(v->fd,&st)==-1){
+        die("open");
+    }
+    v->size=st.st_size;
+    v->index=malloc(sizeof(off_t)*DELULU_VIEW_INDEX_MAX);
+    if(v->index==NULL){
+        die("malloc");
+    }
+    v->index[0]=0;
+    v->nindex=1;
+    v->stride=DELULU_VIEW_STRIDE;
+    v->total=-1;
+    v->exact=1;
+    v->active=1;
+    pthread_mutex_init(&v->lock,NULL);
+    if(pthread_create(&v->thread,NULL,editor_view_thread,v)!=0){
+        die("pthread_create");
+    }
+    v->indexing=1;
+}
+
+// Polled from the input loop: returns 1 when indexing moved on and the status bar should show it
+int editor_view_tick(){
+    struct editor_view *v=&E.view;
+    if(!v->indexing){
+        return 0;
+    }
+    if(__atomic_load_n(&v->done,__ATOMIC_ACQUIRE)){
+        pthread_join(v->thread,NULL);
+        v->indexing=0;
+    }
+    editor_view_locate();
+    return 1;
+}
+
+// Move the screen down (n>0) or up (n<0) by n lines
+void editor_view_scroll(long long n){
+    struct editor_view *v=&E.view;
+    while(n>0){
+        off_t next;
+        editor_view_line(v->top,NULL,0,&next);
+        if(next>=v->size){
+            break; // the last line stays on screen
+        }
+        v->top=next;
+        v->line++;
+        n--;
+    }
+    while(n<0&&v->top>0){
+        v->top=editor_view_linestart(v->top-1);
+        v->line--;
+        n++;
+    }
+}
+
+void editor_view_goto(long long line){
+    struct editor_view *v=&E.view;
+    v->top=editor_view_seek(&line,&v->exact);
+    v->line=line;
+    editor_view_locate();
+}
+
+void editor_view_keypress(int c){
+    struct editor_view *v=&E.view;
+    switch(c){
+    case ARROW_UP:
+        editor_view_scroll(-1);
+        break;
+    case ARROW_DOWN:
+        editor_view_scroll(1);
+        break;
+    case PAGE_UP:
+        editor_view_scroll(-E.screenrows);
+        break;
+    case PAGE_DOWN:
+        editor_view_scroll(E.screenrows);
+        break;
+    case ARROW_LEFT:
+        if(E.coloff>0){
+            E.coloff--;
+        }
+        break;
+    case ARROW_RIGHT:
+        E.coloff++;
+        break;
+    case HOME_KEY:
+        v->top=0;
+        v->line=0;
+        v->exact=1;
+        break;
+    case END_KEY:
+        v->top=editor_view_linestart(v->size>0?v->size-1:0);
+        v->exact=0;
+        editor_view_locate();
+        editor_view_scroll(-(E.screenrows-1));
+        break;
+    case CTRL_KEY('g'):
+    {
+        char *s=editorPrompt("Go to line: %s (ESC to cancel)");
+        if(s){
+            long long line=atoll(s);
+            free(s);
+            editor_view_goto(line>0?line-1:0);
+        }
+        break;
+    }
+    case CTRL_KEY('s'):
+        editor_setstatus_Message("Read-only: the file was opened with -R");
+        break;
+    }
+}
+
+void editor_view_draw_rows(struct abuf *ab){
+    struct editor_view *v=&E.view;
+    int cap=E.coloff+E.screencols; // tabs only ever widen a line,so this many bytes fill the screen
+    if(v->bufcap<cap+E.screencols){
+        v->bufcap=cap+E.screencols;
+        v->buf=realloc(v->buf,v->bufcap);
+    }
+    char *raw=v->buf,*out=v->buf+cap;
+    off_t off=v->top;
+    int y;
+    for(y=0;y<E.screenrows;y++){
+        if(off<v->size||(y==0&&v->size==0)){
+            off_t next;
+            int n=editor_view_line(off,raw,cap,&next),col=0,len=0,j;
+            if(n>0&&raw[n-1]=='\r'&&next-off==n+1){
+                n--; // CRLF line end
+            }
+            for(j=0;j<n&&col<cap;j++){
+                int w=raw[j]=='\t'?DELULU_TAB_STOP-col%DELULU_TAB_STOP:1;
+                while(w-->0&&col<cap){
+                    if(col>=E.coloff){
+                        out[len++]=raw[j]=='\t'?' ':raw[j];
+                    }
+                    col++;
+                }
+            }
+            ab_append(ab,out,len);
+            off=next>off?next:v->size;
+        }else{
+            ab_append(ab,"~",1);
+        }
+        ab_append(ab,"\x1b[K",3);
+        ab_append(ab,"\r\n",2);
+    }
+}
+
+// Status bar text while viewing: where the screen is in lines and in bytes
+void editor_view_status(char *status,int *len,int slen,char *rstatus,int *rlen,int rslen){
+    struct editor_view *v=&E.view;
+    pthread_mutex_lock(&v->lock);
+    long long total=v->total;
+    off_t indexed=v->indexed;
+    pthread_mutex_unlock(&v->lock);
+    int pct=v->size?(int)(v->top*100/v->size):100;
+    if(total>=0){
+        *len=snprintf(status,slen,"%.20s - %lld lines [view]",E.filename,total);
+    }else{
+        *len=snprintf(status,slen,"%.20s - indexing %d%% [view]",E.filename,v->size?(int)(indexed*100/v->size):100);
+    }
+    *rlen=snprintf(rstatus,rslen,"%s%lld | %d%%",v->exact?"":"~",v->line+1,pct);
+}
+
+/*folding*/
+// Ctrl+F folds the block under the cursor row,or the one the cursor is in,and opens a fold again;
+// Alt+F folds every top-level block or opens them all. Blocks come from indentation: the rows
+// after a header that are indented deeper,blank ones between them and a closing bracket at the
+// header's own indent. Folds are kept sorted and disjoint with the count of rows hidden before
+// each,so going between a row and its place on screen is a binary search over the folds and a
+// fold costs the same whether it hides ten rows or a million.
+
+// Folds that start before row
+int editor_fold_count(int row){
+    int lo=0,hi=E.folds.n;
+    while(lo<hi){
+        int mid=(lo+hi)/2;
+        if(E.folds.f[mid].start<row){
+            lo=mid+1;
+        }else{
+            hi=mid;
+        }
+    }
+    return lo;
+}
+
+// Fold hiding row or -1
+int editor_fold_hiding(int row){
+    int k=editor_fold_count(row);
+    return k>0&&row<=E.folds.f[k-1].end?k-1:-1;
+}
+
+// Fold with row as its header or -1
+int editor_fold_header(int row){
+    int k=editor_fold_count(row);
+    return k<E.folds.n&&E.folds.f[k].start==row?k:-1;
+}
+
+// Place of row among the rows shown,a hidden row gives its header's
+int editor_fold_visible(int row){
+    if(E.folds.n==0){
+        return row;
+    }
+    int k=editor_fold_count(row);
+    if(k>0&&row<=E.folds.f[k-1].end){
+        return E.folds.f[k-1].start-E.folds.hidden[k-1];
+    }
+    return row-E.folds.hidden[k];
+}
+
+// Row shown at place v
+int editor_fold_row(int v){
+    if(E.folds.n==0){
+        return v;
+    }
+    int lo=0,hi=E.folds.n; // folds whose header is shown before v
+    while(lo<hi){
+        int mid=(lo+hi)/2;
+        if(E.folds.f[mid].start-E.folds.hidden[mid]<v){
+            lo=mid+1;
+        }else{
+            hi=mid;
+        }
+    }
+    return v+E.folds.hidden[lo];
+}
+
+// Next and previous row shown
+int editor_fold_next(int row){
+    int i=E.folds.n?editor_fold_header(row):-1;
+    return i>=0?E.folds.f[i].end+1:row+1;
+}
+
+int editor_fold_prev(int row){
+    int i=E.folds.n?editor_fold_hiding(row-1):-1;
+    return i>=0?E.folds.f[i].start:row-1;
+}
+
+// The folds changed from row at on
+void editor_fold_sums(int at){
+    struct editor_folds *fl=&E.folds;
+    int i;
+    fl->hidden=realloc(fl->hidden,sizeof(int)*(fl->n+1));
+    fl->hidden[0]=0;
+    for(i=0;i<fl->n;i++){
+        fl->hidden[i+1]=fl->hidden[i]+fl->f[i].end-fl->f[i].start;
+    }
+    editor_index_moved(&E.wrap.index,at); // hidden rows take no visual lines
+}
+
+// Rows were inserted at at (delta>0) or deleted from there (delta<0): folds after them move along,
+// a fold they fall into is opened
+void editor_fold_rows(int at,int delta){
+    struct editor_folds *fl=&E.folds;
+    int i,n=0,last=delta<0?at-delta:at,from=at;
+    if(fl->n==0){
+        return;
+    }
+    for(i=0;i<fl->n;i++){
+        struct fold_range r=fl->f[i];
+        if(r.start>=last){
+            r.start+=delta;
+            r.end+=delta;
+        }else if(r.end>=at){
+            if(r.start<from){
+                from=r.start; // its rows from there on are shown again
+            }
+            continue;
+        }
+        fl->f[n++]=r;
+    }
+    fl->n=n;
+    editor_fold_sums(from);
+}
+
+// Hide rows start+1..end behind start,folds inside it go
+void editor_fold_add(int start,int end){
+    struct editor_folds *fl=&E.folds;
+    int k=editor_fold_count(start),m=k;
+    while(m<fl->n&&fl->f[m].start<=end){
+        m++;
+    }
+    if(m>k&&fl->f[m-1].end>end){
+        end=fl->f[m-1].end;
+    }
+    if(m==k&&fl->n==fl->cap){
+        fl->cap=fl->cap?fl->cap*2:16;
+        fl->f=realloc(fl->f,sizeof(*fl->f)*fl->cap);
+    }
+    memmove(&fl->f[k+1],&fl->f[m],sizeof(*fl->f)*(fl->n-m));
+    fl->n+=k+1-m;
+    fl->f[k].start=start;
+    fl->f[k].end=end;
+    editor_fold_sums(start);
+}
+
+void editor_fold_clear(){
+    E.folds.n=0;
+    editor_fold_sums(0);
+}
+
+void editor_fold_open(int i){
+    struct editor_folds *fl=&E.folds;
+    int start=fl->f[i].start;
+    memmove(&fl->f[i],&fl->f[i+1],sizeof(*fl->f)*(fl->n-i-1));
+    fl->n--;
+    editor_fold_sums(start);
+}
+
+// Columns of leading blanks in row j,-1 when there is nothing else
+int editor_fold_indent(int j){
+    erow *row=&E.row[j];
+    int i=0;
+    while(i<row->rsize&&row->render[i]==' '){
+        i++;
+    }
+    return i<row->rsize?i:-1;
+}
+
+// Last row of the block under header h,h when nothing after it is indented deeper
+int editor_fold_block(int h){
+    int in=editor_fold_indent(h),end=h,j;
+    if(in<0){
+        return h;
+    }
+    for(j=h+1;j<E.numrows;j++){
+        int d=editor_fold_indent(j);
+        if(d>=0&&d<=in){
+            break;
+        }
+        if(d>in){
+            end=j; // blank rows after the block stay out of it
+        }
+    }
+    if(end>h&&j<E.numrows&&editor_fold_indent(j)==in&&memchr("}])",E.row[j].render[in],3)){
+        end=j; // the closing bracket goes with it
+    }
+    return end;
+}
+
+void editor_fold_toggle(){
+    if(E.cy>=E.numrows){
+        return;
+    }
+    int i=editor_fold_header(E.cy);
+    if(i>=0){
+        editor_setstatus_Message("Unfolded %d lines",E.folds.f[i].end-E.folds.f[i].start);
+        editor_fold_open(i);
+        return;
+    }
+    int h=E.cy,end=editor_fold_block(h);
+    if(end==h){
+        // Not a header itself: fold the block it is in,under the nearest row above indented less
+        int in=editor_fold_indent(E.cy),limit=in<0?INT_MAX:in;
+        for(h=editor_fold_prev(E.cy);h>=0;h=editor_fold_prev(h)){
+            int d=editor_fold_indent(h);
+            if(d>=0&&d<limit){
+                if((end=editor_fold_block(h))>=E.cy){
+                    break;
+                }
+                limit=d;
+            }
+        }
+        if(h<0){
+            editor_setstatus_Message("Nothing to fold here");
+            return;
+        }
+    }
+    editor_fold_add(h,end);
+    E.cy=h;
+    if(E.cx>E.row[h].size){
+        E.cx=E.row[h].size;
+    }
+    editor_setstatus_Message("Folded %d lines",end-h);
+}
+
+// Fold every top-level block,or open every fold when there are some
+void editor_fold_all(){
+    struct editor_folds *fl=&E.folds;
+    int j;
+    if(fl->n>0){
+        editor_fold_clear();
+        editor_setstatus_Message("Unfolded everything");
+        return;
+    }
+    for(j=0;j<E.numrows;j++){
+        int end=editor_fold_indent(j)==0?editor_fold_block(j):j;
+        if(end>j){
+            if(fl->n==fl->cap){
+                fl->cap=fl->cap?fl->cap*2:16;
+                fl->f=realloc(fl->f,sizeof(*fl->f)*fl->cap);
+            }
+            fl->f[fl->n].start=j;
+            fl->f[fl->n++].end=end;
+            j=end;
+        }
+    }
+    editor_fold_sums(0);
+    int i=editor_fold_hiding(E.cy);
+    if(i>=0){
+        E.cy=fl->f[i].start; // onto the header rather than opening it again
+        E.cx=0;
+    }
+    editor_setstatus_Message("Folded %d blocks",fl->n);
+}
+
+// Scrolling and the cursor never rest on a hidden row: whatever put the cursor there opens its
+// fold,the top of the screen goes to the header
+void editor_fold_scroll(){
+    int i=editor_fold_hiding(E.cy);
+    if(i>=0){
+        editor_fold_open(i);
+    }
+    if((i=editor_fold_hiding(E.rowoff))>=0){
+        E.rowoff=E.folds.f[i].start;
+        E.wrap.sub=0;
+    }
+}
+
+// " [+N lines]" after a fold's header when it fits in the cols left
+void editor_fold_marker(struct abuf *ab,int row,int cols){
+    int i=editor_fold_header(row);
+    if(i>=0){
+        char m[32];
+        int len=snprintf(m,sizeof(m)," [+%d lines]",E.folds.f[i].end-E.folds.f[i].start);
+        if(len<=cols){
+            ab_append(ab,"\x1b[7m",4);
+            ab_append(ab,m,len);
+            ab_append(ab,"\x1b[m",3);
+        }
+    }
+}
+
+/*multiple cursors*/
+// Alt+Down/Alt+Up add a cursor in the same column on the next row,so a column of them can be
+// typed into at once. A keystroke is applied at every cursor in one pass and each row it
+// touched is rendered once,not once per cursor. E.cy/E.cx stays the cursor the screen follows.
+int editor_cursors_cmp(const void *a,const void *b){
+    const struct editor_cursor *x=a,*y=b;
+    return x->cy!=y->cy?(x->cy<y->cy?-1:1):(x->cx>y->cx)-(x->cx<y->cx);
+}
+
+void editor_cursors_clear(){
+    E.cursors.n=0;
+}
+
+// Sort the extra cursors and drop the ones that ended up where another one is
+void editor_cursors_normalize(){
+    struct editor_cursors *m=&E.cursors;
+    int i,k=0;
+    if(m->n==0){
+        return;
+    }
+    qsort(m->c,m->n,sizeof(*m->c),editor_cursors_cmp);
+    for(i=0;i<m->n;i++){
+        struct editor_cursor *c=&m->c[i];
+        if((c->cy==E.cy&&c->cx==E.cx)||(k>0&&c->cy==m->c[k-1].cy&&c->cx==m->c[k-1].cx)){
+            continue;
+        }
+        m->c[k++]=*c;
+    }
+    m->n=k;
+}
+
+void editor_cursors_push(int cy,int cx){
+    struct editor_cursors *m=&E.cursors;
+    if(m->n==m->cap){
+        m->cap=m->cap?m->cap*2:16;
+        m->c=realloc(m->c,sizeof(*m->c)*m->cap);
+    }
+    m->c[m->n].cy=cy;
+    m->c[m->n].cx=cx;
+    m->c[m->n++].main=0;
+}
+
+// First extra cursor on row or after it
+int editor_cursors_find(int row){
+    int lo=0,hi=E.cursors.n;
+    while(lo<hi){
+        int mid=(lo+hi)/2;
+        if(E.cursors.c[mid].cy<row){
+            lo=mid+1;
+        }else{
+            hi=mid;
+        }
+    }
+    return lo;
+}
+
+// Rows were inserted or deleted (see editor_rows_moved): cursors below follow,those on deleted rows go
+void editor_cursors_rows(int at,int delta){
+    struct editor_cursors *m=&E.cursors;
+    int i,k=0;
+    for(i=0;i<m->n;i++){
+        struct editor_cursor *c=&m->c[i];
+        if(c->cy>=at&&delta<0&&c->cy<at-delta){
+            continue;
+        }
+        if(c->cy>=at){
+            c->cy+=delta;
+        }
+        m->c[k++]=*c;
+    }
+    m->n=k;
+}
+
+// Alt+Down (dir 1) or Alt+Up (dir -1): a new cursor on the row shown after the lowest cursor or
+// before the highest. It becomes the one the screen follows.
+void editor_cursors_add(int dir){
+    struct editor_cursors *m=&E.cursors;
+    int y=E.cy;
+    if(m->n==0){
+        m->col=E.cy<E.numrows?editor_rowcxtorx(&E.row[E.cy],E.cx):0;
+    }else if(dir>0&&m->c[m->n-1].cy>y){
+        y=m->c[m->n-1].cy;
+    }else if(dir<0&&m->c[0].cy<y){
+        y=m->c[0].cy;
+    }
+    int next=dir>0?editor_fold_next(y):y>0?editor_fold_prev(y):-1;
+    if(next<0||next>=E.numrows){
+        return;
+    }
+    editor_cursors_push(E.cy,E.cx);
+    E.cy=next;
+    E.cx=editor_rowrxtocx(&E.row[next],m->col);
+    editor_cursors_normalize();
+    editor_setstatus_Message("%d cursors (ESC for one)",m->n+1);
+}
+
+// Apply one keystroke at every cursor: dir 0 inserts s,-1 deletes the character before each
+// cursor and 1 the one after it. Nothing joins rows,a cursor with nothing to delete on its row
+// stays put. Cursors on a row are done right to left so the columns of the ones still to come
+// hold,and each row is rendered once when all of its cursors are done.
+void editor_cursors_edit(const char *s,size_t len,int dir){
+    struct editor_cursors *m=&E.cursors;
+    int n=m->n+1,i,j,k;
+    if(dir==0&&len==0){
+        return;
+    }
+    TRACE_BEGIN(trace);
+    struct editor_cursor *all=malloc(sizeof(*all)*n);
+    for(k=0;k<m->n;k++){
+        all[k]=m->c[k];
+    }
+    all[n-1].cy=E.cy;
+    all[n-1].cx=E.cx;
+    all[n-1].main=1;
+    qsort(all,n,sizeof(*all),editor_cursors_cmp);
+    if(dir==0&&all[n-1].cy==E.numrows){
+        editor_AppendRows(E.numrows,"",0);
+    }
+    for(i=n;i>0;i=j){
+        int y=all[i-1].cy,done=0;
+        for(j=i-1;j>0&&all[j-1].cy==y;j--){
+        }
+        if(y>=E.numrows){
+            continue;
+        }
+        erow *row=&E.row[y];
+        int size=row->size,changed=0;
+        for(k=i-1;k>=j;k--){
+            if(dir==0){
+                editor_row_insert(row,all[k].cx,s,len);
+                changed=1;
+            }else{
+                changed|=editor_row_delete(row,dir<0?all[k].cx-1:all[k].cx,1);
+            }
+        }
+        // Each cursor moves by what was done at it and at the cursors left of it
+        for(k=j;k<i;k++){
+            if(dir==0){
+                done+=len;
+            }else if(dir<0&&all[k].cx>0){
+                done++;
+            }
+            all[k].cx-=dir==0?-done:done;
+            if(dir>0&&all[k].cx+done<size){
+                done++;
+            }
+        }
+        if(changed){
+            editor_UpdateRows(row);
+        }
+    }
+    m->n=0;
+    for(k=0;k<n;k++){
+        if(all[k].main){
+            E.cy=all[k].cy;
+            E.cx=all[k].cx;
+        }else{
+            editor_cursors_push(all[k].cy,all[k].cx);
+        }
+    }
+    free(all);
+    editor_cursors_normalize();
+    TRACE_END(trace,"cursors_edit");
+}
+
+// Move every cursor with key,the extra ones take turns in E.cy/E.cx to go through editor_move_cursor
+void editor_cursors_move(int key){
+    struct editor_cursors *m=&E.cursors;
+    int cy=E.cy,cx=E.cx,i;
+    for(i=0;i<=m->n;i++){
+        E.cy=i<m->n?m->c[i].cy:cy;
+        E.cx=i<m->n?m->c[i].cx:cx;
+        if(key==HOME_KEY){
+            E.cx=0;
+        }else if(key==END_KEY){
+            E.cx=E.cy<E.numrows?E.row[E.cy].size:0;
+        }else{
+            editor_move_cursor(key);
+        }
+        if(i<m->n){
+            m->c[i].cy=E.cy;
+            m->c[i].cx=E.cx;
+        }
+    }
+    editor_cursors_normalize();
+}
+
+// A key while there are extra cursors,1 when it was done at all of them. Keys that only make
+// sense at one place drop the extra cursors and are left to act on E.cy/E.cx.
+int editor_cursors_key(int c){
+    char ch=c;
+    switch(c){
+    case BACKSPACE:
+    case CTRL_KEY('h'):
+    case DEL_KEY:
+        editor_cursors_edit(NULL,0,c==DEL_KEY?1:-1);
+        return 1;
+    case ARROW_UP:
+    case ARROW_DOWN:
+    case ARROW_LEFT:
+    case ARROW_RIGHT:
+    case HOME_KEY:
+    case END_KEY:
+        editor_cursors_move(c);
+        return 1;
+    case '\x1b':
+        editor_cursors_clear();
+        return 1;
+    case CTRL_KEY('s'):
+    case CTRL_KEY('q'):
+    case CTRL_KEY('w'):
+    case CTRL_KEY('l'):
+    case PASTE_EVENT: // editor_paste decides
+        return 0;
+    }
+    if(c=='\t'||(c>=32&&c<256&&c!=127)){
+        editor_cursors_edit(&ch,1,0);
+        return 1;
+    }
+    editor_cursors_clear();
+    return 0;
+}
+
+// Render columns from..to of row j with the extra cursors on it in inverse video,one at the end
+// of the row gets a block after it when room allows. Returns the screen columns used.
+int editor_cursors_draw(struct abuf *ab,int j,int from,int to,int room){
+    erow *row=&E.row[j];
+    int i=E.cursors.n?editor_cursors_find(j):0,at=from,used=to-from;
+    for(;i<E.cursors.n&&E.cursors.c[i].cy==j;i++){
+        int cx=E.cursors.c[i].cx,rx=editor_rowcxtorx(row,cx<row->size?cx:row->size);
+        if(rx<from||rx>to||(rx==to&&(to<row->rsize||used>=room))){
+            continue;
+        }
+        ab_append(ab,&row->render[at],rx-at);
+        ab_append(ab,"\x1b[7m",4);
+        ab_append(ab,rx<to?&row->render[rx]:" ",1);
+        ab_append(ab,"\x1b[m",3);
+        at=rx+1;
+        if(rx==to){
+            used++;
+        }
+    }
+    if(at<to){
+        ab_append(ab,&row->render[at],to-at);
+    }
+    return used;
+}
+
+/*kill ring*/
+// Ctrl+K cuts the lines selected with Alt+A (or the cursor's line),Alt+6 copies them and Ctrl+U
+// pastes the newest cut above the cursor,Alt+Y right after it swaps in the one before. Lines are
+// never copied: a cut moves its erows into the ring,a copy and a paste share chars and render
+// (editor_rows_put),the row table only gets pointers spliced in or out. An edit of a shared row
+// copies it first (editor_row_reserve).
+void editor_kill_free(int i){
+    struct editor_kill *k=&E.kill;
+    int j;
+    for(j=0;j<k->ring[i].n;j++){
+        editorFreerow(&k->ring[i].rows[j]);
+    }
+    free(k->ring[i].rows);
+    k->ring[i].rows=NULL;
+    k->ring[i].n=0;
+}
+
+// A new entry for n rows,the oldest one goes when the ring is full
+erow *editor_kill_push(int n){
+    struct editor_kill *k=&E.kill;
+    k->last=(k->last+1)%DELULU_KILL_RING;
+    if(k->count<DELULU_KILL_RING){
+        k->count++;
+    }
+    editor_kill_free(k->last);
+    k->ring[k->last].rows=malloc(sizeof(erow)*n);
+    k->ring[k->last].n=n;
+    return k->ring[k->last].rows;
+}
+
+// Rows were inserted or deleted (see editor_rows_moved): the mark stays on its line,or on the
+// line that took its place,and Alt+Y no longer knows where the last paste is
+void editor_kill_rows(int at,int delta){
+    struct editor_kill *k=&E.kill;
+    if(k->mark>=at){
+        k->mark=delta<0&&k->mark<at-delta?at:k->mark+delta;
+    }
+    if(at<k->yank_at+k->yank_n){
+        k->yanked=0;
+    }
+}
+
+// The file changed: offsets the ring's rows were cut or copied with no longer describe it.
+// Rows it shares with the row table lose theirs too,the next save writes those again.
+void editor_kill_disk(){
+    struct editor_kill *k=&E.kill;
+    int i,j;
+    for(i=0;i<DELULU_KILL_RING;i++){
+        for(j=0;j<k->ring[i].n;j++){
+            editor_rowbuf(k->ring[i].rows[j].chars)->disk=-1;
+        }
+    }
+}
+
+int editor_kill_selected(int row){
+    struct editor_kill *k=&E.kill;
+    return k->marking&&row<E.numrows&&(k->mark<E.cy?row>=k->mark&&row<=E.cy:row<=k->mark&&row>=E.cy);
+}
+
+// Rows from *at the selection or the cursor's line covers,0 when there are none
+int editor_kill_range(int *at){
+    struct editor_kill *k=&E.kill;
+    int first=E.cy,last=E.cy;
+    if(k->marking){
+        first=k->mark<E.cy?k->mark:E.cy;
+        last=k->mark<E.cy?E.cy:k->mark;
+        k->marking=0;
+    }
+    if(last>=E.numrows){
+        last=E.numrows-1;
+    }
+    *at=first;
+    return first<=last?last-first+1:0;
+}
+
+// Alt+A
+void editor_kill_mark(){
+    struct editor_kill *k=&E.kill;
+    k->marking=!k->marking;
+    k->mark=E.cy;
+    editor_setstatus_Message(k->marking?"Mark set,Ctrl+K cuts and Alt+6 copies the lines":"Mark unset");
+}
+
+// Ctrl+K
+void editor_kill_cut(){
+    int at,n=editor_kill_range(&at);
+    if(n==0){
+        return;
+    }
+    editor_rows_remove(at,n,editor_kill_push(n));
+    E.cy=at;
+    E.cx=0;
+    editor_setstatus_Message("Cut %d line%s",n,n==1?"":"s");
+}
+
+// Alt+6
+void editor_kill_copy(){
+    int at,n=editor_kill_range(&at),j;
+    if(n==0){
+        return;
+    }
+    erow *rows=editor_kill_push(n);
+    for(j=0;j<n;j++){
+        rows[j]=E.row[at+j];
+        rows[j].chars=editor_chars_share(E.row[at+j].chars);
+        rows[j].render=editor_chars_share(E.row[at+j].render);
+        rows[j].wrap=NULL;
+        rows[j].wrapw=0;
+    }
+    editor_setstatus_Message("Copied %d line%s",n,n==1?"":"s");
+}
+
+// Ctrl+U: entry i above the cursor's line,the cursor ends up after it
+void editor_kill_yank(int i){
+    struct editor_kill *k=&E.kill;
+    if(k->count==0){
+        editor_setstatus_Message("Nothing cut or copied yet");
+        return;
+    }
+    if(E.cy>E.numrows){
+        E.cy=E.numrows;
+    }
+    editor_rows_put(E.cy,k->ring[i].rows,k->ring[i].n);
+    k->yanked=1;
+    k->yank_at=E.cy;
+    k->yank_n=k->ring[i].n;
+    k->yank_i=i;
+    E.cy+=k->ring[i].n;
+    E.cx=0;
+}
+
+// Alt+Y after Ctrl+U: the entry before the one just pasted takes its place
+void editor_kill_pop(){
+    struct editor_kill *k=&E.kill;
+    if(!k->yanked||k->count<2||k->yank_at+k->yank_n>E.numrows){
+        editor_setstatus_Message("Alt+Y only works right after Ctrl+U");
+        return;
+    }
+    int i=(k->yank_i+DELULU_KILL_RING-1)%DELULU_KILL_RING;
+    if(k->ring[i].n==0){
+        i=k->last; // went round the ring
+    }
+    editor_DelRows(k->yank_at,k->yank_n);
+    E.cy=k->yank_at;
+    editor_kill_yank(i);
+}
+
+/*soft wrap*/
+// With Ctrl+W a row takes as many screen lines as it needs,broken after the last blank that fits.
+// Each row keeps its break offsets for the width they were worked out for,an edit lays out
+// only that row again and a resize none at all: rows get laid out when they come on screen.
+// The visual line index sums the lines per row so that scrolling and paging find a visual line
+// in O(log n),rows not laid out yet count as ceil(rsize/width),which is never more than they take.
+long long editor_wrap_count(int row){
+    erow *r=&E.row[row];
+    if(E.folds.n&&editor_fold_hiding(row)>=0){
+        return 0;
+    }
+    if(r->wrapw==E.wrap.width){
+        return r->wraps;
+    }
+    return r->rsize>E.wrap.width?(r->rsize+E.wrap.width-1)/E.wrap.width:1;
+}
+
+// Lay out row j,counted is what the visual line index has for it
+void editor_wrap_layout(int j,long long counted){
+    erow *row=&E.row[j];
+    int w=E.wrap.width,n=0,start=0;
+    while(row->rsize-start>w){
+        int b=start+w;
+        while(b>start&&row->render[b-1]!=' '){
+            b--;
+        }
+        if(b==start){
+            b=start+w; // a word longer than the screen is cut
+        }
+        if((n&(n-1))==0){
+            row->wrap=realloc(row->wrap,sizeof(int)*(n?n*2:1)); // room doubles at powers of two
+        }
+        row->wrap[n++]=b;
+        start=b;
+    }
+    row->wraps=n+1;
+    row->wrapw=w;
+    editor_index_add(&E.wrap.index,j,editor_wrap_count(j)-counted);
+}
+
+void editor_wrap_row(int j){
+    if(j<E.numrows&&E.row[j].wrapw!=E.wrap.width){
+        editor_wrap_layout(j,editor_wrap_count(j));
+    }
+}
+
+// Render offset where visual line sub of row j starts,the row is laid out
+int editor_wrap_start(int j,int sub){
+    return sub>0?E.row[j].wrap[sub-1]:0;
+}
+
+// Visual line of row j holding render column rx
+int editor_wrap_sub(int j,int rx){
+    if(j>=E.numrows){
+        return 0;
+    }
+    editor_wrap_row(j);
+    int lo=0,hi=E.row[j].wraps-1;
+    while(lo<hi){
+        int mid=(lo+hi+1)/2;
+        if(E.row[j].wrap[mid-1]<=rx){
+            lo=mid;
+        }else{
+            hi=mid-1;
+        }
+    }
+    return lo;
+}
+
+// Visual lines above row j
+long long editor_wrap_vline(int j){
+    return editor_index_sum(&E.wrap.index,editor_wrap_count,j);
+}
+
+// The screen got a different width: every layout is stale,the index starts over from estimates
+void editor_wrap_resize(){
+    if(E.wrap.on&&E.wrap.width!=E.screencols){
+        E.wrap.width=E.screencols>0?E.screencols:1;
+        E.wrap.sub=0;
+        editor_index_moved(&E.wrap.index,0);
+    }
+}
+
+void editor_wrap_toggle(){
+    E.wrap.on=!E.wrap.on;
+    E.wrap.width=0;
+    E.wrap.sub=0;
+    E.coloff=0;
+    editor_wrap_resize();
+    editor_setstatus_Message(E.wrap.on?"Soft wrap on":"Soft wrap off");
+}
+
+// editor_scroll for wrapped rows: keep the cursor's visual line on screen
+void editor_wrap_scroll(){
+    struct editor_wrap *w=&E.wrap;
+    int csub=editor_wrap_sub(E.cy,E.rx),j;
+    E.coloff=0;
+    if(E.rowoff<E.numrows){
+        editor_wrap_row(E.rowoff);
+        if(w->sub>=E.row[E.rowoff].wraps){
+            w->sub=E.row[E.rowoff].wraps-1;
+        }
+    }else{
+        w->sub=0;
+    }
+    if(E.cy<E.rowoff||(E.cy==E.rowoff&&csub<w->sub)){
+        E.rowoff=E.cy;
+        w->sub=csub;
+        return;
+    }
+    long long d=editor_wrap_vline(E.cy)-editor_wrap_vline(E.rowoff)+csub-w->sub;
+    if(d<E.screenrows){
+        // Estimates only ever undercount,so the rows in between are less than a screen
+        for(j=E.rowoff;j<E.cy;j=editor_fold_next(j)){
+            editor_wrap_row(j);
+        }
+        d=editor_wrap_vline(E.cy)-editor_wrap_vline(E.rowoff)+csub-w->sub;
+        if(d<E.screenrows){
+            return;
+        }
+    }
+    // Put the cursor on the bottom line: go a screen minus one up from it
+    int row=E.cy,sub=csub,left=E.screenrows-1;
+    while(left>sub&&row>0){
+        left-=sub+1;
+        row=editor_fold_prev(row);
+        editor_wrap_row(row);
+        sub=E.row[row].wraps-1;
+    }
+    E.rowoff=row;
+    w->sub=left>sub?0:sub-left;
+}
+
+// Where the cursor is on the screen,after editor_wrap_scroll
+void editor_wrap_cursor(int *y,int *x){
+    int csub=editor_wrap_sub(E.cy,E.rx);
+    *y=editor_wrap_vline(E.cy)-editor_wrap_vline(E.rowoff)+csub-E.wrap.sub;
+    *x=E.cy<E.numrows?E.rx-editor_wrap_start(E.cy,csub):0;
+}
+
+// Up or down one visual line,the cursor stays in its screen column
+void editor_wrap_move(int dir){
+    int rx=E.cy<E.numrows?editor_rowcxtorx(&E.row[E.cy],E.cx):0;
+    int sub=editor_wrap_sub(E.cy,rx),cy=E.cy;
+    int col=E.cy<E.numrows?rx-editor_wrap_start(E.cy,sub):0;
+    sub+=dir;
+    if(sub<0){
+        if(cy==0){
+            return;
+        }
+        cy=editor_fold_prev(cy);
+        editor_wrap_row(cy);
+        sub=E.row[cy].wraps-1;
+    }else if(cy>=E.numrows){
+        return;
+    }else if(sub>=E.row[cy].wraps){
+        cy=editor_fold_next(cy);
+        sub=0;
+    }
+    E.cy=cy;
+    if(cy>=E.numrows){
+        E.cx=0;
+        return;
+    }
+    erow *row=&E.row[cy];
+    int start=editor_wrap_start(cy,sub),end=sub<row->wraps-1?row->wrap[sub]-1:row->rsize;
+    E.cx=editor_rowrxtocx(row,start+col<end?start+col:end);
+}
+
+// PgUp/PgDn: a screen up from the top line or down from the bottom one,found in the index
+void editor_wrap_page(int dir){
+    long long top=editor_wrap_vline(E.rowoff)+E.wrap.sub,sub;
+    long long v=dir<0?top-E.screenrows:top+2*E.screenrows-1;
+    E.cy=editor_index_find(&E.wrap.index,editor_wrap_count,v<0?0:v,&sub);
+    E.cx=0;
+    if(E.cy<E.numrows){
+        editor_wrap_row(E.cy);
+        if(sub>=E.row[E.cy].wraps){
+            sub=E.row[E.cy].wraps-1; // the estimate was high
+        }
+        E.cx=editor_rowrxtocx(&E.row[E.cy],editor_wrap_start(E.cy,sub));
+    }
+}
+
+void editor_wrap_draw_rows(struct abuf *ab){
+    int j=E.rowoff,sub=E.wrap.sub,y;
+    for(y=0;y<E.screenrows;y++){
+        if(j<E.numrows){
+            editor_wrap_row(j);
+            erow *row=&E.row[j];
+            int start=editor_wrap_start(j,sub),end=sub<row->wraps-1?row->wrap[sub]:row->rsize;
+            int selected=editor_kill_selected(j);
+            if(selected){
+                ab_append(ab,"\x1b[4m",4);
+            }
+            int used=editor_cursors_draw(ab,j,start,end,E.screencols);
+            if(selected){
+                ab_append(ab,"\x1b[m",3);
+            }
+            if(++sub==row->wraps){
+                editor_fold_marker(ab,j,E.screencols-used);
+                sub=0;
+                j=editor_fold_next(j);
+            }
+        }else{
+            ab_append(ab,"~",1);
+        }
+        ab_append(ab,"\x1b[K\r\n",5);
+    }
+}
+
+/*perf*/
+// Histogram bucket of v: values below DELULU_HIST_SUB have their own bucket,above that each
+// power of two is split into DELULU_HIST_SUB equal parts
+int editor_hist_index(unsigned long long v)
+{
+    if (v < DELULU_HIST_SUB)
+    {
+        return v;
+    }
+    int e = 63 - __builtin_clzll(v); // v is in [2^e,2^(e+1))
+    return (e - 3) * DELULU_HIST_SUB + ((v >> (e - 4)) & (DELULU_HIST_SUB - 1));
+}
+
+// Largest value that lands in bucket i
+unsigned long long editor_hist_upper(int i)
+{
+    if (i < DELULU_HIST_SUB)
+    {
+        return i;
+    }
+    int e = i / DELULU_HIST_SUB + 3;
+    return ((unsigned long long)(DELULU_HIST_SUB + i % DELULU_HIST_SUB + 1) << (e - 4)) - 1;
+}
+
+// Each histogram has one writer,readers on the other thread only ever see stale counts
+void editor_hist_record(struct editor_hist *h, long long v)
+{
+    if (v < 0)
+    {
+        v = 0;
+    }
+    int i = editor_hist_index(v);
+    __atomic_store_n(&h->count[i], h->count[i] + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&h->n, h->n + 1, __ATOMIC_RELAXED);
+    if ((unsigned long long)v > h->max)
+    {
+        __atomic_store_n(&h->max, v, __ATOMIC_RELAXED);
+    }
+}
+
+// Value at percentile p (0-100),the top of its bucket
+long long editor_hist_pct(struct editor_hist *h, double p)
+{
+    unsigned long long n = __atomic_load_n(&h->n, __ATOMIC_RELAXED), seen = 0;
+    unsigned long long want = (unsigned long long)(n * p / 100.0 + 0.5);
+    unsigned long long max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+    int i;
+    if (n == 0)
+    {
+        return 0;
+    }
+    for (i = 0; i < DELULU_HIST_BUCKETS; i++)
+    {
+        seen += __atomic_load_n(&h->count[i], __ATOMIC_RELAXED);
+        if (seen >= want && seen)
+        {
+            return editor_hist_upper(i) < max ? editor_hist_upper(i) : max;
+        }
+    }
+    return max;
+}
+
+long long editor_now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// A frame reached the terminal: the keys it shows have their latency
+void editor_perf_frame_done(struct abuf *f)
+{
+    if (f->key_at)
+    {
+        long long lat = editor_now_ns() - f->key_at;
+        editor_hist_record(&E.perf.latency, lat);
+        __atomic_store_n(&E.perf.last_latency, lat, __ATOMIC_RELAXED);
+        f->key_at = 0;
+    }
+}
+
+// ns as a short human readable duration
+char *editor_perf_fmt(char *buf, size_t len, long long ns)
+{
+    if (ns >= 1000000)
+    {
+        snprintf(buf, len, "%.1fms", ns / 1e6);
+    }
+    else
+    {
+        snprintf(buf, len, "%lldus", ns / 1000);
+    }
+    return buf;
+}
+
+long long editor_perf_rss()
+{
+    long long size = 0, resident = 0;
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if (fp)
+    {
+        if (fscanf(fp, "%lld %lld", &size, &resident) != 2)
+        {
+            resident = 0;
+        }
+        fclose(fp);
+    }
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+void editor_perf_dump_hist(FILE *fp, const char *name, struct editor_hist *h)
+{
+    int i;
+    fprintf(fp, "%s: n=%llu p50=%.1fus p90=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus\n", name,
+            __atomic_load_n(&h->n, __ATOMIC_RELAXED), editor_hist_pct(h, 50) / 1e3, editor_hist_pct(h, 90) / 1e3,
+            editor_hist_pct(h, 99) / 1e3, editor_hist_pct(h, 99.9) / 1e3, __atomic_load_n(&h->max, __ATOMIC_RELAXED) / 1e3);
+    for (i = 0; i < DELULU_HIST_BUCKETS; i++)
+    {
+        unsigned long long c = __atomic_load_n(&h->count[i], __ATOMIC_RELAXED);
+        if (c)
+        {
+            fprintf(fp, "  %.3f-%.3fus %llu\n", (i ? editor_hist_upper(i - 1) + 1 : 0) / 1e3, editor_hist_upper(i) / 1e3, c);
+        }
+    }
+}
+
+// Open a dump file for writing without following a symlink planted at path. For a default
+// name under /tmp (tmp set) only the editor's own earlier dump is replaced: the unlink fails
+// on another user's file and O_EXCL then refuses whatever is there.
+FILE *editor_dump_open(const char *path, int tmp)
+{
+    int flags = O_WRONLY | O_CREAT | O_NOFOLLOW | O_CLOEXEC;
+    if (tmp)
+    {
+        unlink(path);
+        flags |= O_EXCL;
+    }
+    else
+    {
+        flags |= O_TRUNC;
+    }
+    int fd = open(path, flags, 0600);
+    if (fd == -1)
+    {
+        return NULL;
+    }
+    FILE *fp = fdopen(fd, "w");
+    if (fp == NULL)
+    {
+        close(fd);
+    }
+    return fp;
+}
+
+// Write every histogram to DELULU_PERF_FILE or /tmp/delulu-perf.<pid>.txt
+void editor_perf_dump()
+{
+    char path[256];
+    char *env = getenv("DELULU_PERF_FILE");
+    if (env)
+    {
+        snprintf(path, sizeof(path), "%s", env);
+    }
+    else
+    {
+        snprintf(path, sizeof(path), "/tmp/delulu-perf.%d.txt", (int)getpid());
+    }
+    FILE *fp = editor_dump_open(path, env == NULL);
+    if (fp == NULL)
+    {
+        editor_setstatus_Message("Can't write %s: %s", path, strerror(errno));
+        return;
+    }
+    fprintf(fp, "delulu %s: %s,%d rows,rss %lld KB,%lld frames dropped\n", delulu_VERSION,
+            E.filename ? E.filename : "[No Name]", E.numrows, editor_perf_rss() >> 10, E.render.dropped);
+    editor_perf_dump_hist(fp, "key to screen latency", &E.perf.latency);
+    editor_perf_dump_hist(fp, "keypress handling", &E.perf.keypress);
+    editor_perf_dump_hist(fp, "frame build", &E.perf.frame);
+    fclose(fp);
+    editor_setstatus_Message("Performance histograms written to %s", path);
+}
+
+/*render thread*/
+// Frames are composed on the edit thread and written to the terminal by the render thread.
+// They travel through two lock-free SPSC rings: ready (edit -> render) and free (render -> edit).
+// Each frame redraws the whole screen,so the render thread only draws the newest one
+// and hands the ones it skipped straight back.
+int frame_queue_push(struct frame_queue *q, struct abuf *f)
+{
+    size_t head = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    if (head - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) == DELULU_FRAMES)
+    {
+        return 0;
+    }
+    q->slot[head & (DELULU_FRAMES - 1)] = f;
+    __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+struct abuf *frame_queue_pop(struct frame_queue *q)
+{
+    size_t tail = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+    if (tail == __atomic_load_n(&q->head, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+    struct abuf *f = q->slot[tail & (DELULU_FRAMES - 1)];
+    __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);
+    return f;
+}
+
+/*terminal output*/
+// Frames go out with writev once poll() says the terminal takes more: short writes carry on
+// where they stopped,so a big frame is never cut off. stdout itself stays blocking,its file
+// description is shared with the shell and whatever runs after the editor.
+// Terminals that support synchronized output (DEC mode 2026) get each frame wrapped in
+// begin/end markers and show it all at once instead of tearing halfway through.
+#define SYNC_BEGIN "\x1b[?2026h"
+#define SYNC_END "\x1b[?2026l"
+
+void editor_term_writev(struct iovec *iov, int n)
+{
+    while (n > 0)
+    {
+        struct pollfd fd = {STDOUT_FILENO, POLLOUT, 0};
+        if (poll(&fd, 1, -1) == -1 && errno != EINTR)
+        {
+            return;
+        }
+        if (fd.revents & (POLLERR | POLLHUP | POLLNVAL))
+        {
+            return; // the terminal is gone,nothing sensible to do from here
+        }
+        if (!(fd.revents & POLLOUT))
+        {
+            continue; // interrupted,the terminal is behind
+        }
+        ssize_t w = writev(STDOUT_FILENO, iov, n);
+        if (w == -1)
+        {
+            if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                continue;
+            }
+            return;
+        }
+        // Skip what was written,possibly stopping inside a segment
+        while (n > 0 && (size_t)w >= iov->iov_len)
+        {
+            w -= iov->iov_len;
+            iov++;
+            n--;
+        }
+        if (n > 0)
+        {
+            iov->iov_base = (char *)iov->iov_base + w;
+            iov->iov_len -= w;
+        }
+    }
+}
+
+void editor_term_frame(struct abuf *f)
+{
+    TRACE_BEGIN(trace);
+    struct iovec iov[3] = {{SYNC_BEGIN, sizeof(SYNC_BEGIN) - 1}, {f->b, f->len}, {SYNC_END, sizeof(SYNC_END) - 1}};
+    if (E.render.sync)
+    {
+        editor_term_writev(iov, 3);
+    }
+    else
+    {
+        editor_term_writev(&iov[1], 1);
+    }
+    TRACE_END(trace, "write");
+}
+
+// Ask the terminal whether it knows mode 2026 (DECRQM),followed by a primary device attributes
+// request every terminal answers,so one that ignores the first question doesn't cost a timeout.
+// DELULU_SYNC=0 or 1 in the environment skips the question,and so does a TERM known not to
+// have the mode (the console,GNU screen outside tmux),which would only cost the wait.
+int editor_term_detect_sync()
+{
+    char *env = getenv("DELULU_SYNC");
+    if (env)
+    {
+        return atoi(env) != 0;
+    }
+    static const char *no_sync[] = {"dumb", "linux", "cons", "vt"};
+    const char *term = getenv("TERM");
+    if (term == NULL || term[0] == '\0')
+    {
+        return 0;
+    }
+    if (strncmp(term, "screen", 6) == 0 && getenv("TMUX") == NULL)
+    {
+        return 0; // tmux also calls itself screen,but knows the mode
+    }
+    size_t j;
+    for (j = 0; j < sizeof(no_sync) / sizeof(no_sync[0]); j++)
+    {
+        if (strncmp(term, no_sync[j], strlen(no_sync[j])) == 0)
+        {
+            return 0;
+        }
+    }
+    const char *q = "\x1b[?2026$p\x1b[c";
+    if (write(STDOUT_FILENO, q, strlen(q)) != (ssize_t)strlen(q))
+    {
+        return 0;
+    }
+    // The replies arrive through the input ring like keys,and keys typed meanwhile stay there
+    int sync = 0;
+    size_t i = 0; // Unread input before i is not a reply
+    long long deadline = editor_now_ms() + DELULU_ESC_TIMEOUT * 4;
+    while (1)
+    {
+        int n = editor_input_reply(i);
+        if (n == -1)
+        {
+            long long now = editor_now_ms();
+            struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+            if (now >= deadline || poll(&fd, 1, deadline - now) != 1 || editor_input_fill() == 0)
+            {
+                break;
+            }
+            continue;
+        }
+        if (n == 0)
+        {
+            i++;
+            continue;
+        }
+        // Reply is <esc>[?2026;Ps$y with Ps 1 (set) or 2 (reset) when the mode exists
+        const char *set = "\x1b[?2026;";
+        size_t j;
+        for (j = 0; j < 8 && editor_input_peek(i + j) == set[j]; j++)
+        {
+        }
+        if (j == 8 && (editor_input_peek(i + 8) == '1' || editor_input_peek(i + 8) == '2') &&
+            editor_input_peek(i + 9) == '$')
+        {
+            sync = 1;
+        }
+        int final = editor_input_peek(i + n - 1);
+        editor_input_drop(i, n);
+        if (final == 'c')
+        {
+            break; // the device attributes reply <esc>[?...c ends the answers
+        }
+    }
+    return sync;
+}
+
+void *editor_render_thread(void *arg)
+{
+    (void)arg;
+    char drain[64];
+    while (1)
+    {
+        struct abuf *f = NULL, *g;
+        while ((g = frame_queue_pop(&E.render.ready)) != NULL)
+        {
+            if (f)
+            {
+                if (f->key_at && (g->key_at == 0 || f->key_at < g->key_at))
+                {
+                    g->key_at = f->key_at; // the newer frame shows those keys too
+                }
+                frame_queue_push(&E.render.free, f);
+                __atomic_add_fetch(&E.render.dropped, 1, __ATOMIC_RELAXED);
+            }
+            f = g;
+        }
+        if (f)
+        {
+            editor_term_frame(f);
+            editor_perf_frame_done(f);
+            frame_queue_push(&E.render.free, f);
+            __atomic_thread_fence(__ATOMIC_SEQ_CST); // pairs with the fence in editor_frame_get,the push must be seen before starved is read
+            if (__atomic_exchange_n(&E.render.starved, 0, __ATOMIC_ACQ_REL))
+            {
+                if (write(E.wakefd[1], "r", 1) == -1)
+                {
+                    // pipe full: a wakeup is already pending
+                }
+            }
+            continue; // newer frames may have come in while this one was written
+        }
+        if (__atomic_load_n(&E.render.stop, __ATOMIC_ACQUIRE))
+        {
+            break;
+        }
+        if (read(E.render.pipe[0], drain, sizeof(drain)) == -1 && errno != EINTR)
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+void editor_render_start()
+{
+    E.render.sync = editor_term_detect_sync();
+    if (pipe2(E.render.pipe, O_CLOEXEC) == -1)
+    {
+        return; // frames are written synchronously instead
+    }
+    fcntl(E.render.pipe[1], F_SETFL, O_NONBLOCK);
+    if (pthread_create(&E.render.thread, NULL, editor_render_thread, NULL) != 0)
+    {
+        close(E.render.pipe[0]);
+        close(E.render.pipe[1]);
+        return;
+    }
+    E.render.running = 1;
+}
+
+// Draw everything still queued and stop the render thread,output after this is written directly
+void editor_render_stop()
+{
+    if (!E.render.running)
+    {
+        return;
+    }
+    __atomic_store_n(&E.render.stop, 1, __ATOMIC_RELEASE);
+    if (write(E.render.pipe[1], "q", 1) == -1)
+    {
+        // pipe full: the thread is awake already
+    }
+    pthread_join(E.render.thread, NULL);
+    E.render.running = 0;
+    close(E.render.pipe[0]);
+    close(E.render.pipe[1]);
+}
+
+// A frame buffer to compose into,NULL when every frame is queued or being written.
+// The edit thread never waits for one: the redraw stays pending and the render thread
+// wakes the event loop when it hands a frame back.
+struct abuf *editor_frame_get()
+{
+    struct abuf *f = frame_queue_pop(&E.render.free);
+    if (f == NULL && E.render.frames < DELULU_FRAMES)
+    {
+        f = calloc(1, sizeof(*f));
+        E.render.frames += (f != NULL);
+    }
+    if (f == NULL)
+    {
+        __atomic_store_n(&E.render.starved, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST); // either this pop sees the frame or the render thread sees starved
+        f = frame_queue_pop(&E.render.free); // one may have come back in the meantime
+        if (f)
+        {
+            __atomic_store_n(&E.render.starved, 0, __ATOMIC_RELAXED);
+        }
+    }
+    if (f)
+    {
+        f->len = 0; // the buffer itself is kept for the next frame
+    }
+    return f;
+}
+
+void editor_frame_put(struct abuf *f)
+{
+    if (!E.render.running)
+    {
+        editor_term_frame(f);
+        editor_perf_frame_done(f);
+        frame_queue_push(&E.render.free, f);
+        return;
+    }
+    frame_queue_push(&E.render.ready, f);
+    if (write(E.render.pipe[1], "f", 1) == -1)
+    {
+        // pipe full: the render thread has wakeups pending
+    }
+}
+
+// output functions
+void editor_scroll(){
+    if(E.view.active){
+        E.cy=E.rowoff; // the viewer scrolls by itself,the cursor just sits top left
+        E.rx=E.coloff;
+        return;
+    }
+    if(E.folds.n){
+        editor_fold_scroll();
+    }
+    E.rx=0;
+    if(E.cy<E.numrows){
+        E.rx=editor_rowcxtorx(&E.row[E.cy],E.cx);
+    }
+    if(E.wrap.on){
+        editor_wrap_scroll();
+        return;
+    }
+    // Rows hidden in folds don't count,without folds these are the row numbers
+    int y=editor_fold_visible(E.cy),top=editor_fold_visible(E.rowoff);
+    if(y < top) {
+        E.rowoff = E.cy; // If the cursor is above the visible area, adjust the row offset
+    }
+    if(y >= top + E.screenrows) {
+        E.rowoff = editor_fold_row(y - E.screenrows + 1); // If the cursor is below the visible area, adjust the row offset
+    }
+    if(E.rx<E.coloff){
+        E.coloff=E.rx;
+    }
+    if(E.rx>=E.coloff + E.screencols){
+        E.coloff = E.rx - E.screencols +1;
+    }
+}
+
+// This function draws the rows of the editor to the append buffer
+void editor_draw_rows(struct abuf *ab)
+{
+    // This function would draw the rows of the editor
+    if (E.view.active)
+    {
+        editor_view_draw_rows(ab);
+        return;
+    }
+    if (E.wrap.on && E.numrows > 0)
+    {
+        editor_wrap_draw_rows(ab);
+        return;
+    }
+    int y;
+    int filerow = E.rowoff; // The row to be drawn,rows hidden in folds are skipped
+    for (y = 0; y < E.screenrows; y++)
+    {
+        if (filerow >= E.numrows)
+        {
+            if (E.numrows == 0 && y == E.screenrows / 3)
+            {
+                char welcome[80];
+                int welcome_note = snprintf(welcome, sizeof(welcome), "Delulu Editor - Version %s", delulu_VERSION);
+                int welcomelen = strlen(welcome); // Get the length of the welcome message
+                if (welcomelen > E.screencols)
+                {
+                    welcomelen = E.screencols; // Limit the length to the number of columns
+                }
+                int padding = (E.screencols - welcomelen) / 2; // Calculate padding for centering
+                if (padding)
+                {
+                    ab_append(ab, "~", 1); // Draw the first row with a tilde
+                    // 1 byte long ~ -> tilde char
+                    padding--; // Decrease padding after adding tilde
+                }
+                static const char spaces[] = "                                ";
+                while (padding > 0)
+                {
+                    int n = padding < (int)sizeof(spaces) - 1 ? padding : (int)sizeof(spaces) - 1;
+                    ab_append(ab, spaces, n); // Add spaces for padding,a run at a time
+                    padding -= n;
+                }
+                ab_append(ab, welcome, welcomelen); // Append the welcome message to the buffer
+                // 11 bytes long delulu_VERSION -> version of the text editor
+            }
+            else
+            {
+                ab_append(ab, "~", 1); // Draw the first row with a tilde
+                // 3 bytes long >\r\n -> ~ char,carriage return and newline
+                // \r is carriage return (ASCII 13) and \n is newline (ASCII
+            }
+        }
+        else
+        {
+            int len = E.row[filerow].rsize - E.coloff; // Get the length of the row
+            if(len < 0)
+            {
+                len = 0; // If the length is negative, set it to 0
+            }
+            if (len > E.screencols)
+            {
+                len = E.screencols;
+            }
+            int selected = editor_kill_selected(filerow);
+            if (selected)
+            {
+                ab_append(ab, "\x1b[4m", 4); // lines selected with Alt+A are underlined
+            }
+            len = editor_cursors_draw(ab, filerow, E.coloff, E.coloff + len, E.screencols); // the extra cursors show in inverse video
+            if (selected)
+            {
+                ab_append(ab, "\x1b[m", 3);
+            }
+            editor_fold_marker(ab, filerow, E.screencols - len);
+            filerow = editor_fold_next(filerow);
+        }
+        ab_append(ab, "\x1b[K", 3); // Clear the line
+        // 3 bytes long \x1b[K -> escape sequence to clear the line
+        // for the last line in text editor, we don't want to print a >
+        // if (y < E.screenrows - 1)
+        // {
+        ab_append(ab, "\r\n", 2); // Move to the next line
+            // 2 bytes long \r\n -> carriage return and newline
+        //}
+    }
+}
+
+void editor_draw_StatusBar(struct abuf *ab){
+ab_append(ab,"\x1b[7m]",4);
+char status[160],rstatus[80];
+int len=snprintf(status,sizeof(status),"%.20s - %d lines %s",E.filename ? E.filename :"[No Name]",E.numrows,E.dirty ?"(modified)":"");
+if(E.perf.hud){
+    // Performance HUD in place of the file name: latency of the last key and p99,what the last frame cost
+    char last[24],p99[24],build[24];
+    len=snprintf(status,sizeof(status),"lat %s p99 %s | frame %dB %d rows build p99 %s | rss %lldM",
+        editor_perf_fmt(last,sizeof(last),__atomic_load_n(&E.perf.last_latency,__ATOMIC_RELAXED)),
+        editor_perf_fmt(p99,sizeof(p99),editor_hist_pct(&E.perf.latency,99)),
+        E.perf.frame_bytes,E.perf.frame_rows,editor_perf_fmt(build,sizeof(build),editor_hist_pct(&E.perf.frame,99)),
+        editor_perf_rss()>>20);
+    if(len>=(int)sizeof(status)){
+        len=sizeof(status)-1;
+    }
+}
+int rlen;
+if(E.view.active){
+    char vstatus[sizeof(status)];
+    int vlen;
+    editor_view_status(vstatus,&vlen,sizeof(vstatus),rstatus,&rlen,sizeof(rstatus));
+    if(!E.perf.hud){
+        memcpy(status,vstatus,sizeof(status)); // the HUD keeps the left side when it is on
+        len=vlen;
+    }
+}else if(E.save.active){
+    long long total=E.save.total?E.save.total:1;
+    rlen=snprintf(rstatus,sizeof(rstatus),"saving %lld%% | %d/%d",__atomic_load_n(&E.save.written,__ATOMIC_RELAXED)*100/total,E.cy+1,E.numrows);
+}else{
+    // Where the cursor is in the file as it would be saved
+    long long total=editor_lines_offset(E.numrows),off=editor_lines_offset(E.cy)+(E.cy<E.numrows?E.cx:0);
+    char multi[24]="";
+    if(E.cursors.n){
+        snprintf(multi,sizeof(multi),"%d cursors | ",E.cursors.n+1);
+    }
+    rlen=snprintf(rstatus,sizeof(rstatus),"%s%d/%d @%lld %d%%",multi,E.cy+1,E.numrows,off,total?(int)(off*100/total):100);
+}
+if(len>E.screencols) len = E.screencols;
+ab_append(ab,status,len);
+while(len<E.screencols){
+    if(E.screencols-len == rlen){
+        ab_append(ab,rstatus,rlen);
+        break;
+    }else{
+        ab_append(ab," ",1);
+        len++;
+    }
+}
+ab_append(ab,"\x1b[m",3);
+ab_append(ab,"\r\n",2);
+}
+
+void editor_draw_MessageBar(struct abuf *ab){
+    ab_append(ab,"\x1b[K",3);
+    int msglen=strlen(E.statusmsg);
+    if(msglen>E.screencols){
+        msglen=E.screencols;
+    }
+    if(msglen&&time(NULL)-E.statusmsg_time<5){
+        ab_append(ab,E.statusmsg,msglen);
+    }
+}
+
+void editor_refressh_screen()
+{
+    struct abuf *ab = editor_frame_get(); // Reuse a frame buffer the render thread is done with
+    if (ab == NULL)
+    {
+        return; // every frame is still on its way to the terminal,E.redraw stays set
+    }
+    long long start = editor_now_ns();
+    TRACE_BEGIN(frame);
+    ab->key_at = E.perf.key_at;
+    E.perf.key_at = 0;
+    TRACE_BEGIN(scroll);
+    editor_scroll(); // Scroll the editor if necessary
+    TRACE_END(scroll, "scroll");
+    ab_append(ab, "\x1b[?25l", 6); // Hide the cursor
+    // 6 bytes long \x1b[?25l -> escape sequence to hide the cursor
+    // ab_append(ab,"\x1b[2J", 4); // 4 means we write 4 byt out to terminal,1 byte \x1b ->esc char or 27 in decimal,3 bytes [2J
+    // esc seq strt with esc char 27 followed by [ char
+    // J cmd to clr the screen,arg 2 says clr entrire screen
+    //<esc>[1] clr screen upto where cursor is
+    //<esc>[0] clr screen from cursor to end of screen
+    // 0 default arg for J,so <esc>[J clr screen from cursor to end of screen
+    // We using VT100 esc seq
+    //<esc>[2J cmd left cursor at bottom of screen,so we need to move it to top-left corner to draw editor from top to bottom
+    ab_append(ab, "\x1b[H", 3); // Move cursor to the home position (top-left corner)
+    // 3 bytes long H ->position cursor ,takes 2 arg-row no and col no at which cursor should be placed
+    // example :- <esc>[5;10H moves cursor to 5th row and 10th column
+    // default is 1,1 which is top-left corner of screen
+    // rows,col no starts from 1 not 0,so <esc>[H is same as <esc>[1;1H
+    TRACE_BEGIN(draw);
+    editor_draw_rows(ab); // Draw the rows of the editor
+    editor_draw_StatusBar(ab);
+    editor_draw_MessageBar(ab);
+    TRACE_END(draw, "draw");
+    char buf[32];
+    int cursor_y = editor_fold_visible(E.cy) - editor_fold_visible(E.rowoff), cursor_x = E.rx - E.coloff;
+    if (E.wrap.on && !E.view.active)
+    {
+        editor_wrap_cursor(&cursor_y, &cursor_x);
+    }
+    snprintf(buf,sizeof(buf),"\x1b[%d;%dH",cursor_y+1,cursor_x+1);
+    // 32 bytes long buf -> buffer to hold the cursor position escape sequence
+    // snprintf is used to format the string with cursor position
+    // E.cy and E.cx are the current cursor position in the editor
+    // E.cy is the row number and E.cx is the column number
+    // We add 1 to both E.cy and E.cx because the escape sequence uses 1-based indexing
+    // 1 byte \x1b -> escape char,2 bytes [d;dH -> row no and col no at which cursor should be placed
+    ab_append(ab,buf,strlen(buf)); // Append the cursor position escape sequence to the buffer
+    // strlen(buf) returns the length of the formatted string in buf
+    // 1 byte \x1b -> escape char,2 bytes [d;dH -> row no and col no at which cursor should be placed
+    // write(STDOUT_FILENO, ab.b, ab.len); // Write the buffer to standard output
+    // 1 byte \x1b -> escape char,2 bytes [d;dH -> row no and col no at which cursor should be placed
+    // ab.b is the pointer to the buffer and ab.len is the length of the buffer
+    ab_append(ab,"\x1b[?25h",6); // Show the cursor again
+    editor_hist_record(&E.perf.frame, editor_now_ns() - start);
+    E.perf.frame_bytes = ab->len;
+    E.perf.frame_rows = E.perf.rows_rendered;
+    E.perf.rows_rendered = 0;
+    TRACE_END(frame, "frame");
+    editor_frame_put(ab); // Hand the frame to the render thread
+    E.redraw=0;
+    E.frame_at=editor_now_ms();
+}
+
+void editor_setstatus_Message(const char*fmt,...){
+    va_list ap;
+    va_start(ap,fmt);
+    vsnprintf(E.statusmsg,sizeof(E.statusmsg),fmt,ap);
+    va_end(ap);
+    E.statusmsg_time=time(NULL);
+    E.statusmsg_expire=fmt[0]?editor_now_ms()+5100:0; // wake up to clear it a little after the 5 s shown
+}
+// input functions
+char *editorPrompt(char *prompt){
+    size_t bufsize=128;
+    char *buf=malloc(bufsize);
+    size_t buflen=0;
+    buf[0]='\0';
+    while(1){
+        editor_setstatus_Message(prompt,buf);
+        editor_refressh_screen();
+        int c =key_read_editor();
+        if(c==DEL_KEY||c==CTRL_KEY('h')||c==BACKSPACE){
+            if(buflen!=0){
+                buf[--buflen]='\0';
+            }
+        }
+        else if(c=='\x1b'){
+            editor_setstatus_Message("");
+            free(buf);
+            return NULL;
+        }else if(c=='\r'){
+            if(buflen!=0){
+                editor_setstatus_Message("");
+                return buf;
+            }
+        }else if(c>=32&&c<127){ // plain printable ASCII,modified keys and events are not text
+            if(buflen==bufsize-1){
+                bufsize*=2;
+                buf=realloc(buf,bufsize);
+            }
+            buf[buflen++]=c;
+            buf[buflen]='\0';
+        }
+    }
+}
+
+void editor_move_cursor(int key)
+{
+    erow *row =(E.cy>=E.numrows) ? NULL :&E.row[E.cy];
+    switch (key) // This function moves the cursor based on the key pressed
+    {
+    case ARROW_LEFT:
+        if (E.cx != 0)
+        {
+            E.cx--; // Move cursor left
+        }else if(E.cy>0){
+            E.cy=editor_fold_prev(E.cy);
+            E.cx=E.row[E.cy].size;//Allowing user to press <- at begining of line to move to end of previous line
+        }
+        break;
+    case ARROW_RIGHT:
+        // if (E.cx < E.screencols - 1)
+        // {
+        //     // E.cx < E.screencols - 1 to prevent cursor from moving beyond
+        //     E.cx++; // Move cursor right
+        // }
+        if(row && E.cx <row->size){
+        E.cx++;}else if(row&&E.cx==row->size){
+            E.cy=editor_fold_next(E.cy);
+            E.cx=0; //Allowing user to to press -> at end of line 
+        }
+        break;
+    case ARROW_UP:
+        if (E.wrap.on)
+        {
+            editor_wrap_move(-1); // by screen line,keeps its own column
+            return;
+        }
+        if (E.cy != 0)
+        {
+            // E.cy!=0 to prevent cursor from moving beyond the top of the screen
+            E.cy=editor_fold_prev(E.cy); // Move cursor up,over folded rows
+        }
+        break;
+    case ARROW_DOWN:
+        if (E.wrap.on)
+        {
+            editor_wrap_move(1);
+            return;
+        }
+        if (E.cy < E.numrows)
+        {
+            // E.cy < E.screenrows - 1 to prevent cursor from moving beyond the bottom
+            E.cy=editor_fold_next(E.cy); // Move cursor down
+        }
+        break;
+    }
+    row=(E.cy>=E.numrows) ?NULL:&E.row[E.cy];
+    int rowlen=row?row->size:0;
+    if(E.cx>rowlen){
+        E.cx=rowlen;
+    }
+}
+
+void editor_process_keypress()
+{
+    static int quit_times=DELULU_QUIT_TIMES;
+    TRACE_BEGIN(read);
+    int c = key_read_editor(); // Read a single character from standard input
+    TRACE_END(read, "key_read");
+    if(c==FOCUS_IN||c==FOCUS_OUT){
+        if(c==FOCUS_IN){
+            editor_disk_check(); // the user may have been changing the file somewhere else
+        }
+        return;
+    }
+    if(c!=REDRAW_EVENT){
+        E.perf.key_read=editor_now_ns();
+        if(!E.perf.key_at){
+            E.perf.key_at=E.perf.key_read;
+        }
+    }
+    if((c&~KEY_MODS)==F12_KEY){
+        if(c&KEY_SHIFT){
+            editor_perf_dump(); // Shift+F12
+        }else{
+            E.perf.hud=!E.perf.hud;
+        }
+        return;
+    }
+    if((c==(KEY_ALT|ARROW_DOWN)||c==(KEY_ALT|ARROW_UP))&&!E.view.active){
+        editor_cursors_add(c==(KEY_ALT|ARROW_DOWN)?1:-1);
+        return;
+    }
+    if(c==(KEY_ALT|'f')&&!E.view.active){
+        editor_cursors_clear(); // a closed fold could hide some of them
+        editor_fold_all();
+        return;
+    }
+    if(c!=REDRAW_EVENT&&c!=(KEY_ALT|'y')){
+        E.kill.yanked=0; // Alt+Y has to follow Ctrl+U right away
+    }
+    if((c==(KEY_ALT|'a')||c==(KEY_ALT|'6')||c==(KEY_ALT|'y'))&&!E.view.active){
+        editor_cursors_clear();
+        if(c==(KEY_ALT|'y')){
+            editor_undo_boundary(UNDO_KIND_OTHER);
+            editor_kill_pop();
+        }else if(c==(KEY_ALT|'6')){
+            editor_kill_copy();
+        }else{
+            editor_kill_mark();
+        }
+        return;
+    }
+    if(c==REDRAW_EVENT||((c&KEY_ALT)&&(c&~KEY_MODS)<256)){
+        return; // nothing else is bound to Alt+key yet
+    }
+    c&=~KEY_MODS; // modified keys act like the plain key for now
+    if(E.view.active&&c!=CTRL_KEY('q')){
+        editor_view_keypress(c); // nothing to edit,only quitting is shared
+        return;
+    }
+    if(c==BACKSPACE||c==CTRL_KEY('h')||c==DEL_KEY){
+        editor_undo_boundary(UNDO_KIND_DELETE);
+    }else if(c>=32&&c<256&&c!=127){
+        editor_undo_boundary(UNDO_KIND_TYPING);
+        if(c==' '&&E.cx>0&&E.cy<E.numrows&&E.row[E.cy].chars[E.cx-1]!=' '){
+            E.undo.start=1; // Typing coalesces word by word
+        }
+    }else{
+        editor_undo_boundary(UNDO_KIND_OTHER);
+    }
+    if(E.cursors.n&&editor_cursors_key(c)){
+        quit_times=DELULU_QUIT_TIMES;
+        return; // done at every cursor
+    }
+    switch (c)                 // Process the character
+    {
+    case '\r':
+        /*TODO*/
+        editor_insertNEwline();
+        break;
+    case CTRL_KEY('q'):                     // If Ctrl+Q is pressed
+        if(E.dirty && quit_times>0){
+            editor_setstatus_Message("WARNING!!! File has unsaved changes."
+            "Press Ctrl+q %d more times to quit.",quit_times);
+            quit_times--;
+            return;
+        }
+        editor_cache_position();            // The next open starts where this one left off
+        editor_render_stop();               // Finish drawing before taking the screen back
+        write(STDOUT_FILENO, "\x1b[2J", 4); // Clear the screen
+        write(STDOUT_FILENO, "\x1b[H", 3);  // Move cursor to the home position (top-left corner)
+        editor_save_wait();                 // Let a background save finish first
+        editor_swap_remove();               // Quitting on purpose,nothing to recover
+        if(!E.dirty||E.undo.len==editor_undo_floor()){
+            editor_undo_journal_remove(E.filename); // no unsaved edits for a later session to redo
+        }
+        exit(0);                            // Exit the program
+        break;
+    case CTRL_KEY('s'):
+        editor_save();
+        break;
+    case CTRL_KEY('z'):
+        editor_undo();
+        break;
+    case CTRL_KEY('y'):
+        editor_redo();
+        break;
+    case CTRL_KEY('g'):
+        editor_goto();
+        break;
+    case CTRL_KEY('w'):
+        editor_wrap_toggle();
+        break;
+    case CTRL_KEY('f'):
+        editor_fold_toggle();
+        break;
+    case CTRL_KEY('k'):
+        editor_kill_cut();
+        break;
+    case CTRL_KEY('u'):
+        editor_kill_yank(E.kill.last);
+        break;
+    case PASTE_EVENT:
+        editor_paste();
+        break;
+    case HOME_KEY: // If Home key is pressed
+        E.cx = 0;  // Move cursor to the beginning of the line
+        break;
+    case END_KEY:                // If End key is pressed
+        if(E.cy<E.numrows){
+            E.cx = E.row[E.cy].size; // Move cursor to the end
+        }
+        break;
+    case BACKSPACE:
+    case CTRL_KEY('h'):
+    case DEL_KEY:
+        if(c==DEL_KEY){
+            editor_move_cursor(ARROW_RIGHT);
+        }
+        editor_delchar();
+        break;
+    case PAGE_UP:
+    case PAGE_DOWN:
+    {
+        editor_scroll(); // keys handled without a frame in between have not scrolled yet
+        if(E.wrap.on){
+            editor_wrap_page(c==PAGE_UP?-1:1);
+            break;
+        }
+        if(c==PAGE_UP){
+            E.cy=E.rowoff;
+        }else if(c==PAGE_DOWN){
+            E.cy=editor_fold_row(editor_fold_visible(E.rowoff)+E.screenrows-1);
+            if(E.cy>E.numrows){
+                E.cy=E.numrows;
+            }
+        }
+        int times = E.screenrows; // Number of rows to move the cursor
+        while (times--)
+        {
+            editor_move_cursor(c == PAGE_UP ? ARROW_UP : ARROW_DOWN); // Move the cursor up or down based on the key pressed
+        }
+    }
+    case ARROW_UP:
+    case ARROW_DOWN:
+    case ARROW_LEFT:
+    case ARROW_RIGHT:
+        editor_move_cursor(c); // Move the cursor based on the key pressed
+        break;
+    case CTRL_KEY('l'):
+    case '\x1b':
+        break;
+    default:
+        if(c<256){
+            editor_insertchar(c); // keys we have no binding for (function keys,Insert) are ignored
+        }
+        break;
+    }
+    quit_times=DELULU_QUIT_TIMES;
+}
+
+// init
+void editor_init()
+{
+    // This function initializes the editor configuration
+    E.cx = 0;      // Initialize cursor x position
+    E.cy = 0;      // Initialize cursor y position
+    E.rx=0;
+    E.rowoff = 0;  // Initialize row offset for scrolling
+    E.coloff = 0;  // Initialize column offset for scrolling
+    E.numrows = 0; // Initialize num of rows
+    E.row=NULL;  //Initialise rows to NULL
+    E.dirty=0;
+    E.filename=NULL;
+    E.statusmsg[0]='\0';
+    E.statusmsg_time=0;
+    memset(&E.swap,0,sizeof(E.swap));
+    E.swap.fd=-1;
+    E.disk_ok=0;
+    E.disk_path=NULL;
+    signal(SIGHUP,editor_swap_signal);
+    signal(SIGTERM,editor_swap_signal);
+    memset(&E.undo,0,sizeof(E.undo));
+    E.undo.last=-1;
+    E.undo.jfd=-1;
+    E.statusmsg_expire=0;
+    E.resized=0;
+    E.redraw=1;
+    E.frame_at=0;
+    E.frame_ms=DELULU_FPS?1000/DELULU_FPS:0;
+    char *fps=getenv("DELULU_FPS");
+    if(fps){
+        int n=atoi(fps);
+        E.frame_ms=n>0?1000/n:0;
+    }
+    if (pipe2(E.wakefd, O_NONBLOCK | O_CLOEXEC) == -1)
+    {
+        die("pipe");
+    }
+    signal(SIGWINCH, editor_wake_signal); // Resizes are handled as they happen
+    TRACE_INIT();
+    memset(&E.render, 0, sizeof(E.render));
+    memset(&E.perf, 0, sizeof(E.perf));
+    editor_render_start();
+    // Initialize the editor configuration
+    editor_update_window_size();
+}
+
+#ifndef DELULU_NO_MAIN // delulu_replay.c includes this file and brings its own main
+int main(int argc, char *argv[])
+{
+    int opt, view = 0, follow = 0;
+    while ((opt = getopt(argc, argv, "RF")) != -1)
+    {
+        switch (opt)
+        {
+        case 'R':
+            view = 1; // Read-only viewer,the file is paged in rather than loaded
+            break;
+        case 'F':
+            follow = 1; // Keep appending what is written to the file
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-R | -F] [file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if ((view || follow) && optind >= argc)
+    {
+        fprintf(stderr, "%s: %s needs a file\n", argv[0], view ? "-R" : "-F");
+        return 1;
+    }
+    if (view && follow)
+    {
+        fprintf(stderr, "%s: -R and -F can't be combined\n", argv[0]);
+        return 1;
+    }
+    set_terminal_raw_mode(); // Set terminal to raw mode
+    editor_init();           // Its job is to initialize the editor configuration, including getting the terminal size
+    if (optind < argc && view)
+    {
+        editor_view_open(argv[optind]);
+    }
+    else if (optind < argc)
+    {
+        editor_open(argv[optind]);
+        if (follow)
+        {
+            editor_follow_start(argv[optind]);
+            E.cy = E.numrows > 0 ? E.numrows - 1 : 0; // start at the end,like tail -f
+        }
+    }
+    // Read characters from standard input until 'p' is pressed
+    // char c;
+    // while(read(STDIN_FILENO,&c,1)==1 && (c!='p')){ //read file until p is not triggered
+    //     // printf("%s ",&c); to check the input
+    //     if(iscntrl(c)){
+    //         printf("%d\r\n", c); // Print control character as its ASCII value
+    //     }else{
+    //         printf("%d ('%c')\r\n",c, c); // Print regular character
+    //     }
+    // }
+    if (E.statusmsg[0] == '\0') // editor_open may have something more important to say
+    {
+        editor_setstatus_Message(E.view.active ? "HELP: Home/End/PgUp/PgDn | Ctrl+G=go to line | Ctrl+Q=quit"
+                                               : "HELP: Ctrl+S=save | Ctrl+Q=quit | Ctrl+Z/Y=un/redo | Ctrl+G=goto | Ctrl+W=wrap");
+    }
+    while (1)
+    {
+        // char c='\0';
+
+        // // read(STDIN_FILENO, &c, 1); // Read a single character from standard input
+        // if(read(STDIN_FILENO, &c, 1)==-1 && errno!=EAGAIN){ // Read a single character from standard input
+        //     die("read"); // Handle read error
+        // }
+
+        // if(iscntrl(c)){ // Check if the character is a control character
+        //     printf("%d\r\n", c); // Print control character as its ASCII value
+        // } else {
+        //     printf("%d ('%c')\r\n", c, c); // Print regular character with its ASCII value
+        // }
+        // // }if(c=='p'){ // If 'p' is pressed, exit the loop
+        // //     break; // Exit the loop
+        // // }
+        // if(c == CTRL_KEY('q')) { // If Ctrl+Q is pressed, exit the loop
+        //     break; // Exit the loop
+        // }
+        editor_frame();            // Refresh the screen unless more keys are waiting
+        TRACE_BEGIN(key);
+        editor_process_keypress(); // Process keypresses
+        TRACE_END(key, "process_keypress");
+        if(E.perf.key_read){
+            editor_hist_record(&E.perf.keypress,editor_now_ns()-E.perf.key_read);
+            E.perf.key_read=0;
+        }
+        E.redraw=1;
+    }
+    return 0;
+}
+#endif
+
+/* This program sets the terminal to raw mode, reads characters from standard input,
+ and prints their ASCII values. It handles control characters differently by printing their ASCII values.
+ tcsetattr(), read(),tcgetattr() are system calls used to control terminal behavior ;if return -1, it indicates an error occurred, and we handle it using the die() function which prints the error message and exits the program.
+ CTRL_KEY macro bitwise-ANDs a char with val 00011111,in binary, which effectively converts a control key to its ASCII value. For example, CTRL_KEY('a') would yield 1 (0x01), CTRL_KEY('b') would yield 2 (0x02), and so on. 
+ This allows us to easily check for control key combinations in the input handling loop.Ctrl key in terminal strips 5 & 6 bits from whatever key is pressed and send that
+ key_read_editor job is to wait for 1 keypress and return it, later we expand func to handle escape seq,involving multiple bytes representing single keypresses like arrow keys, function keys, etc.
+ The editor_process_keypress waits for keypress & then handles it,later it'll map various Ctrl combinations & other special keys to diff editor funct,& insert any alphanumeric characters and other printable keys char into text thats being edited
+ editor_process_keypress belongs in {terminal} section bcoz it deals with low-level terminal ip,whereas editor_process_keypress is more about handling user input and processing key presses in the context of an editor.
+ The separation allows for better organization of code,making it easier to maintain and extend functionality in the future.
+ */
+
  //last step done is 130
\ No newline at end of file
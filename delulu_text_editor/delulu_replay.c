@@ -0,0 +1,441 @@
+// Headless replay harness: drives the editor core from a recorded keystroke script and reports
+// per-operation latency,frame build time,bytes sent to the terminal and allocations.
+//
+//   make delulu_replay
+//   ./delulu_replay [-n repeat] [-r rows] [-c cols] [-o edited-copy] script [file]
+//
+// A script is the raw bytes a terminal sends (keys,escape sequences,bracketed pastes),
+// e.g. bench/typing.keys. It should not contain Ctrl+Q. The file is edited as a scratch
+// copy in a temporary directory,the original and its sidecar files are never touched.
+// The fake terminal is a pseudo-terminal: a feeder thread types the script into it and a
+// drain thread counts what the render thread writes back.
+#define DELULU_NO_MAIN
+#include "delulu.c"
+
+#include <dirent.h>
+
+// Allocation counters,the Makefile links with -Wl,--wrap for each of these
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+static long long replay_allocs[4]; // malloc,calloc,realloc,free
+
+void *__wrap_malloc(size_t size)
+{
+    __atomic_add_fetch(&replay_allocs[0], 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    __atomic_add_fetch(&replay_allocs[1], 1, __ATOMIC_RELAXED);
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    __atomic_add_fetch(&replay_allocs[2], 1, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr)
+{
+    if (ptr)
+    {
+        __atomic_add_fetch(&replay_allocs[3], 1, __ATOMIC_RELAXED);
+    }
+    __real_free(ptr);
+}
+
+enum replay_op
+{
+    OP_INSERT = 0,
+    OP_NEWLINE,
+    OP_DELETE,
+    OP_MOVE,
+    OP_PASTE,
+    OP_UNDO,
+    OP_OTHER,
+    OP_FRAME, // frame build,timed separately after every operation
+    OP_COUNT,
+};
+
+static const char *replay_op_names[OP_COUNT] = {"insert", "newline", "delete", "move", "paste", "undo/redo", "other", "frame build"};
+
+struct replay_samples
+{
+    long long *ns;
+    size_t len, cap;
+};
+
+struct replay
+{
+    int master;              // Our end of the fake terminal
+    char *script;
+    size_t script_len;
+    int repeat;
+    int fed;                 // The feeder thread has typed everything
+    long long out_bytes;     // Bytes the editor wrote to the terminal
+    struct replay_samples samples[OP_COUNT];
+} R;
+
+long long replay_now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void replay_sample(int op, long long ns)
+{
+    struct replay_samples *s = &R.samples[op];
+    if (s->len == s->cap)
+    {
+        s->cap = s->cap ? s->cap * 2 : 1024;
+        s->ns = __real_realloc(s->ns, s->cap * sizeof(*s->ns)); // our own bookkeeping stays out of the counts
+    }
+    s->ns[s->len++] = ns;
+}
+
+int replay_cmp(const void *a, const void *b)
+{
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+int replay_classify(int key)
+{
+    key &= ~KEY_MODS;
+    switch (key)
+    {
+    case '\r':
+        return OP_NEWLINE;
+    case BACKSPACE:
+    case CTRL_KEY('h'):
+    case DEL_KEY:
+        return OP_DELETE;
+    case ARROW_UP:
+    case ARROW_DOWN:
+    case ARROW_LEFT:
+    case ARROW_RIGHT:
+    case PAGE_UP:
+    case PAGE_DOWN:
+    case HOME_KEY:
+    case END_KEY:
+        return OP_MOVE;
+    case PASTE_START:
+        return OP_PASTE;
+    case CTRL_KEY('z'):
+    case CTRL_KEY('y'):
+        return OP_UNDO;
+    }
+    return (key >= 32 && key < 256) ? OP_INSERT : OP_OTHER;
+}
+
+void *replay_feeder(void *arg)
+{
+    (void)arg;
+    int i;
+    for (i = 0; i < R.repeat; i++)
+    {
+        size_t off = 0;
+        while (off < R.script_len)
+        {
+            ssize_t n = write(R.master, R.script + off, R.script_len - off);
+            if (n == -1)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            off += n;
+        }
+    }
+    __atomic_store_n(&R.fed, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+void *replay_drain(void *arg)
+{
+    (void)arg;
+    char buf[65536];
+    while (1)
+    {
+        ssize_t n = read(R.master, buf, sizeof(buf));
+        if (n <= 0)
+        {
+            if (n == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            return NULL;
+        }
+        __atomic_add_fetch(&R.out_bytes, n, __ATOMIC_RELAXED);
+    }
+}
+
+char *replay_slurp(const char *path, size_t *len)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd == -1 || fstat(fd, &st) == -1)
+    {
+        return NULL;
+    }
+    char *buf = __real_malloc(st.st_size + 1);
+    size_t off = 0;
+    while (off < (size_t)st.st_size)
+    {
+        ssize_t n = read(fd, buf + off, st.st_size - off);
+        if (n <= 0)
+        {
+            break;
+        }
+        off += n;
+    }
+    close(fd);
+    *len = off;
+    return buf;
+}
+
+// Copy file into a fresh temporary directory,returns the copy's path
+char *replay_scratch(const char *file, char *dir)
+{
+    if (mkdtemp(dir) == NULL)
+    {
+        return NULL;
+    }
+    const char *base = strrchr(file, '/') ? strrchr(file, '/') + 1 : file;
+    char *path = __real_malloc(strlen(dir) + strlen(base) + 2);
+    sprintf(path, "%s/%s", dir, base);
+    size_t len = 0;
+    char *data = replay_slurp(file, &len);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (data == NULL || fd == -1 || write(fd, data, len) != (ssize_t)len)
+    {
+        return NULL;
+    }
+    close(fd);
+    __real_free(data);
+    return path;
+}
+
+// Remove the scratch directory: the copy and whatever sidecar files the editor left next to it
+void replay_cleanup(const char *dir)
+{
+    DIR *d = opendir(dir);
+    struct dirent *ent;
+    while (d && (ent = readdir(d)) != NULL)
+    {
+        if (strcmp(ent->d_name, ".") && strcmp(ent->d_name, ".."))
+        {
+            unlinkat(dirfd(d), ent->d_name, 0);
+        }
+    }
+    if (d)
+    {
+        closedir(d);
+    }
+    rmdir(dir);
+}
+
+void replay_report(FILE *out, long long elapsed, long long ops, long long frames, long long allocs[4])
+{
+    int i;
+    fprintf(out, "%-12s %8s %10s %10s %10s %10s\n", "op", "count", "p50 us", "p90 us", "p99 us", "max us");
+    for (i = 0; i < OP_COUNT; i++)
+    {
+        struct replay_samples *s = &R.samples[i];
+        if (s->len == 0)
+        {
+            continue;
+        }
+        qsort(s->ns, s->len, sizeof(*s->ns), replay_cmp);
+        fprintf(out, "%-12s %8zu %10.2f %10.2f %10.2f %10.2f\n", replay_op_names[i], s->len,
+                s->ns[s->len * 50 / 100] / 1e3, s->ns[s->len * 90 / 100] / 1e3,
+                s->ns[s->len * 99 / 100] / 1e3, s->ns[s->len - 1] / 1e3);
+    }
+    fprintf(out, "operations: %lld in %.3f s wall time\n", ops, elapsed / 1e9);
+    fprintf(out, "terminal output: %lld bytes,%lld per frame,%lld frames dropped by the render thread\n",
+            R.out_bytes, frames ? R.out_bytes / frames : 0, E.render.dropped);
+    fprintf(out, "allocations: malloc %lld calloc %lld realloc %lld free %lld (%.2f per operation)\n",
+            allocs[0], allocs[1], allocs[2], allocs[3],
+            ops ? (double)(allocs[0] + allocs[1] + allocs[2]) / ops : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+    int rows = 24, cols = 80, opt;
+    char *keep = NULL;
+    R.repeat = 1;
+    while ((opt = getopt(argc, argv, "n:r:c:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            R.repeat = atoi(optarg);
+            break;
+        case 'r':
+            rows = atoi(optarg);
+            break;
+        case 'c':
+            cols = atoi(optarg);
+            break;
+        case 'o':
+            keep = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n repeat] [-r rows] [-c cols] [-o edited-copy] script [file]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (optind >= argc || R.repeat < 1)
+    {
+        fprintf(stderr, "usage: %s [-n repeat] [-r rows] [-c cols] [-o edited-copy] script [file]\n", argv[0]);
+        return 2;
+    }
+    R.script = replay_slurp(argv[optind], &R.script_len);
+    if (R.script == NULL)
+    {
+        perror(argv[optind]);
+        return 1;
+    }
+    char dir[] = "/tmp/delulu-replay-XXXXXX";
+    char *file = NULL;
+    if (optind + 1 < argc && (file = replay_scratch(argv[optind + 1], dir)) == NULL)
+    {
+        perror(argv[optind + 1]);
+        return 1;
+    }
+
+    // The fake terminal: stdin and stdout become the slave side of a pseudo-terminal
+    FILE *out = fdopen(dup(STDOUT_FILENO), "w");
+    R.master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (R.master == -1 || grantpt(R.master) == -1 || unlockpt(R.master) == -1)
+    {
+        perror("posix_openpt");
+        return 1;
+    }
+    int slave = open(ptsname(R.master), O_RDWR | O_NOCTTY);
+    struct winsize ws = {rows, cols, 0, 0};
+    if (slave == -1 || ioctl(slave, TIOCSWINSZ, &ws) == -1)
+    {
+        perror("pty");
+        return 1;
+    }
+    dup2(slave, STDIN_FILENO);
+    dup2(slave, STDOUT_FILENO);
+    close(slave);
+    setenv("DELULU_SYNC", "0", 0); // nothing on the other end answers terminal queries
+
+    pthread_t drain, feeder;
+    pthread_create(&drain, NULL, replay_drain, NULL);
+    set_terminal_raw_mode();
+    editor_init();
+    if (file)
+    {
+        editor_open(file);
+    }
+    editor_refressh_screen();
+
+    long long base[4], allocs[4];
+    int i;
+    for (i = 0; i < 4; i++)
+    {
+        base[i] = __atomic_load_n(&replay_allocs[i], __ATOMIC_RELAXED);
+    }
+    long long ops = 0, frames = 0, start = replay_now_ns();
+    pthread_create(&feeder, NULL, replay_feeder, NULL);
+    while (1)
+    {
+        int key;
+        if (E.in.head == E.in.tail || editor_decode_key(&key) == 0)
+        {
+            // Out of decoded input: wait for more unless the whole script has been typed
+            int fed = __atomic_load_n(&R.fed, __ATOMIC_ACQUIRE);
+            struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+            if (poll(&fd, 1, fed ? 0 : 100) == 1)
+            {
+                editor_input_fill();
+                continue;
+            }
+            if (fed && E.in.head == E.in.tail)
+            {
+                break;
+            }
+            if (fed)
+            {
+                E.in.tail = E.in.head; // a truncated escape sequence at the end of the script
+                break;
+            }
+            continue;
+        }
+        int op = replay_classify(key);
+        long long t0 = replay_now_ns();
+        editor_process_keypress();
+        replay_sample(op, replay_now_ns() - t0);
+        long long t1, t2;
+        E.redraw = 1;
+        while (1)
+        {
+            // Every frame is measured: if all frame buffers are still with the render thread,
+            // wait for one to come back instead of letting the frame be skipped
+            t1 = replay_now_ns();
+            editor_refressh_screen();
+            t2 = replay_now_ns();
+            if (!E.redraw)
+            {
+                break;
+            }
+            struct pollfd fd = {E.wakefd[0], POLLIN, 0};
+            char drain[64];
+            if (poll(&fd, 1, 10) == 1 && read(E.wakefd[0], drain, sizeof(drain)) == -1)
+            {
+                // nothing to drain after all
+            }
+        }
+        replay_sample(OP_FRAME, t2 - t1);
+        ops++;
+        frames++;
+    }
+    long long elapsed = replay_now_ns() - start;
+    for (i = 0; i < 4; i++)
+    {
+        allocs[i] = __atomic_load_n(&replay_allocs[i], __ATOMIC_RELAXED) - base[i];
+    }
+    pthread_join(feeder, NULL);
+    editor_save_wait();
+    editor_render_stop();
+    usleep(100000); // let the drain thread count the last frame
+
+    if (keep && E.filename)
+    {
+        // Save the scratch copy through the editor's own save and hand it out for checking
+        editor_save();
+        editor_save_wait();
+        size_t len = 0;
+        char *data = replay_slurp(E.filename, &len);
+        int fd = open(keep, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (data == NULL || fd == -1 || write(fd, data, len) != (ssize_t)len)
+        {
+            fprintf(out, "could not write %s\n", keep);
+        }
+        close(fd);
+        __real_free(data);
+    }
+    editor_swap_remove();
+    editor_undo_journal_close();
+    if (file)
+    {
+        replay_cleanup(dir);
+    }
+    fprintf(out, "delulu replay: %s x%d on %dx%d%s%s\n", argv[optind], R.repeat, cols, rows,
+            file ? "," : "", file ? argv[optind + 1] : "");
+    replay_report(out, elapsed, ops, frames, allocs);
+    fclose(out);
+    return 0;
+}
@@ -93,20 +93,26 @@ int main(){
     //     }
     // }
 
-    while(1){
-        char c='\0';
+    int done=0;
+    while(!done){
+        char buf[256]; // Take everything the terminal has in one read instead of a syscall per byte
+        int i;
+        ssize_t n=read(STDIN_FILENO, buf, sizeof(buf));
 
         // read(STDIN_FILENO, &c, 1); // Read a single character from standard input
-        if(read(STDIN_FILENO, &c, 1)==-1 && errno!=EAGAIN){ // Read a single character from standard input
+        if(n==-1 && errno!=EAGAIN){ // Read the pending characters from standard input
             die("read"); // Handle read error
         }
 
-        if(iscntrl(c)){ // Check if the character is a control character
-            printf("%d\r\n", c); // Print control character as its ASCII value
-        } else {
-            printf("%d ('%c')\r\n", c, c); // Print regular character with its ASCII value
-        }if(c=='p'){ // If 'p' is pressed, exit the loop
-            break; // Exit the loop
+        for(i=0;i<n&&!done;i++){
+            char c=buf[i];
+            if(iscntrl(c)){ // Check if the character is a control character
+                printf("%d\r\n", c); // Print control character as its ASCII value
+            } else {
+                printf("%d ('%c')\r\n", c, c); // Print regular character with its ASCII value
+            }if(c=='p'){ // If 'p' is pressed, exit the loop
+                done=1; // Exit the loop
+            }
         }
     }
     return 0;